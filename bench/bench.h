@@ -0,0 +1,75 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <ctime>
+
+// Benchmark suites, each one prints its own results.
+void PkgNameBench(void);
+void FileReaderBench(void);
+void CuMiscBench(void);
+
+// Counted by the operator new replacement and the -Wl,--wrap syscall wrappers in bench_counters.cpp.
+extern std::atomic<uint64_t> g_benchAllocNum;
+extern std::atomic<uint64_t> g_benchSyscallNum;
+// Set by "--json", BenchReport() then prints one JSON object per line instead of a table row.
+extern bool g_benchJson;
+
+typedef struct {
+    double nsPerOp;
+    double allocsPerOp;
+    double syscallsPerOp;
+} BenchResult;
+
+inline uint64_t BenchGetTimeNs(void)
+{
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+template <typename T>
+inline void BenchKeep(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template <typename Func>
+BenchResult BenchRun(const Func &func, const uint64_t &iterations)
+{
+    for (uint64_t i = 0; i < iterations / 10 + 1; i++) {
+        func();
+    }
+    uint64_t startAllocNum = g_benchAllocNum.load(std::memory_order_relaxed);
+    uint64_t startSyscallNum = g_benchSyscallNum.load(std::memory_order_relaxed);
+    uint64_t startNs = BenchGetTimeNs();
+    for (uint64_t i = 0; i < iterations; i++) {
+        func();
+    }
+    uint64_t endNs = BenchGetTimeNs();
+    uint64_t allocNum = g_benchAllocNum.load(std::memory_order_relaxed) - startAllocNum;
+    uint64_t syscallNum = g_benchSyscallNum.load(std::memory_order_relaxed) - startSyscallNum;
+
+    BenchResult result{};
+    result.nsPerOp = (double)(endNs - startNs) / (double)iterations;
+    result.allocsPerOp = (double)allocNum / (double)iterations;
+    result.syscallsPerOp = (double)syscallNum / (double)iterations;
+    return result;
+}
+
+// opsPerRun splits a run that loops over several inputs into per-input numbers.
+inline void BenchReport(const std::string &name, const BenchResult &result, const size_t &opsPerRun = 1)
+{
+    double nsPerOp = result.nsPerOp / opsPerRun;
+    double allocsPerOp = result.allocsPerOp / opsPerRun;
+    double syscallsPerOp = result.syscallsPerOp / opsPerRun;
+    if (g_benchJson) {
+        printf("{\"name\":\"%s\",\"ns_per_op\":%.1f,\"allocs_per_op\":%.2f,\"syscalls_per_op\":%.2f}\n",
+            name.c_str(), nsPerOp, allocsPerOp, syscallsPerOp);
+    } else {
+        printf("%-48s %12.1f ns/op %8.2f allocs/op %8.2f syscalls/op\n", name.c_str(), nsPerOp, allocsPerOp, syscallsPerOp);
+    }
+}
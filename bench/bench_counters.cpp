@@ -0,0 +1,161 @@
+#include <new>
+#include <cstdlib>
+#include <cstdarg>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "bench.h"
+
+std::atomic<uint64_t> g_benchAllocNum(0);
+std::atomic<uint64_t> g_benchSyscallNum(0);
+bool g_benchJson = false;
+
+// Every heap allocation of the benchmark binary goes through here.
+void* operator new(size_t size)
+{
+    g_benchAllocNum.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = malloc(size > 0 ? size : 1);
+    if (ptr == nullptr) {
+        std::abort();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    g_benchAllocNum.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t &tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+// The benchmark target links with -Wl,--wrap=<name> for each of these (see CMakeLists.txt), so calls from
+// src/ land here first. The fortified variants are wrapped too, _FORTIFY_SOURCE turns open()/read() into them.
+extern "C" {
+int __real_open(const char* path, int flags, ...);
+int __real___open_2(const char* path, int flags);
+int __real_openat(int dirFd, const char* path, int flags, ...);
+int __real___openat_2(int dirFd, const char* path, int flags);
+ssize_t __real_read(int fd, void* buf, size_t count);
+ssize_t __real___read_chk(int fd, void* buf, size_t count, size_t bufSize);
+ssize_t __real_pread64(int fd, void* buf, size_t count, off64_t offset);
+ssize_t __real_write(int fd, const void* buf, size_t count);
+int __real_close(int fd);
+int __real_fstat(int fd, struct stat* st);
+int __real_fstatat(int dirFd, const char* path, struct stat* st, int flags);
+int __real_chmod(const char* path, mode_t mode);
+
+int __wrap_open(const char* path, int flags, ...)
+{
+    mode_t mode = 0;
+    if ((flags & O_CREAT) != 0) {
+        va_list arg;
+        va_start(arg, flags);
+        mode = (mode_t)va_arg(arg, int);
+        va_end(arg);
+    }
+    g_benchSyscallNum.fetch_add(1, std::memory_order_relaxed);
+    return __real_open(path, flags, mode);
+}
+
+int __wrap___open_2(const char* path, int flags)
+{
+    g_benchSyscallNum.fetch_add(1, std::memory_order_relaxed);
+    return __real___open_2(path, flags);
+}
+
+int __wrap_openat(int dirFd, const char* path, int flags, ...)
+{
+    mode_t mode = 0;
+    if ((flags & O_CREAT) != 0) {
+        va_list arg;
+        va_start(arg, flags);
+        mode = (mode_t)va_arg(arg, int);
+        va_end(arg);
+    }
+    g_benchSyscallNum.fetch_add(1, std::memory_order_relaxed);
+    return __real_openat(dirFd, path, flags, mode);
+}
+
+int __wrap___openat_2(int dirFd, const char* path, int flags)
+{
+    g_benchSyscallNum.fetch_add(1, std::memory_order_relaxed);
+    return __real___openat_2(dirFd, path, flags);
+}
+
+ssize_t __wrap_read(int fd, void* buf, size_t count)
+{
+    g_benchSyscallNum.fetch_add(1, std::memory_order_relaxed);
+    return __real_read(fd, buf, count);
+}
+
+ssize_t __wrap___read_chk(int fd, void* buf, size_t count, size_t bufSize)
+{
+    g_benchSyscallNum.fetch_add(1, std::memory_order_relaxed);
+    return __real___read_chk(fd, buf, count, bufSize);
+}
+
+ssize_t __wrap_pread64(int fd, void* buf, size_t count, off64_t offset)
+{
+    g_benchSyscallNum.fetch_add(1, std::memory_order_relaxed);
+    return __real_pread64(fd, buf, count, offset);
+}
+
+ssize_t __wrap_write(int fd, const void* buf, size_t count)
+{
+    g_benchSyscallNum.fetch_add(1, std::memory_order_relaxed);
+    return __real_write(fd, buf, count);
+}
+
+int __wrap_close(int fd)
+{
+    g_benchSyscallNum.fetch_add(1, std::memory_order_relaxed);
+    return __real_close(fd);
+}
+
+int __wrap_fstat(int fd, struct stat* st)
+{
+    g_benchSyscallNum.fetch_add(1, std::memory_order_relaxed);
+    return __real_fstat(fd, st);
+}
+
+int __wrap_fstatat(int dirFd, const char* path, struct stat* st, int flags)
+{
+    g_benchSyscallNum.fetch_add(1, std::memory_order_relaxed);
+    return __real_fstatat(dirFd, path, st, flags);
+}
+
+int __wrap_chmod(const char* path, mode_t mode)
+{
+    g_benchSyscallNum.fetch_add(1, std::memory_order_relaxed);
+    return __real_chmod(path, mode);
+}
+}
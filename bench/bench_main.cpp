@@ -0,0 +1,17 @@
+#include <cstring>
+#include "bench.h"
+
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            g_benchJson = true;
+        }
+    }
+
+    PkgNameBench();
+    FileReaderBench();
+    CuMiscBench();
+
+    return 0;
+}
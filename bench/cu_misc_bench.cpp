@@ -0,0 +1,190 @@
+#include <vector>
+#include "bench.h"
+#include "utils/cu_misc.h"
+#include "utils/proc_reader.h"
+
+constexpr int FIXTURE_PID_NUM = 2000;
+constexpr int FIXTURE_FIRST_PID = 1000;
+
+static const char* const FIXTURE_NAMES[] = {
+    "com.tencent.mm", "com.tencent.mm:push", "com.android.systemui", "com.google.android.gms.persistent",
+    "system_server", "/system/bin/surfaceflinger", "com.ss.android.ugc.aweme:push", "logd",
+};
+static const int FIXTURE_OOM_SCORE_ADJS[] = { 0, 58, 200, 529, 705, 900, 1000, -1000 };
+
+// A /proc-like tree: <root>/<pid>/{cmdline, oom_adj, oom_score_adj, stat} for FIXTURE_PID_NUM pids.
+static std::string CreateProcFixture_(void)
+{
+    char rootPath[] = "/tmp/CuBenchProcXXXXXX";
+    if (mkdtemp(rootPath) == nullptr) {
+        return "";
+    }
+
+    for (int idx = 0; idx < FIXTURE_PID_NUM; idx++) {
+        int pid = FIXTURE_FIRST_PID + idx;
+        int oomScoreAdj = FIXTURE_OOM_SCORE_ADJS[idx % 8];
+        const auto &taskPath = StrMerge("%s/%d", rootPath, pid);
+        mkdir(taskPath.c_str(), 0755);
+        CreateFile(taskPath + "/cmdline", std::string(FIXTURE_NAMES[idx % 8]) + '\0');
+        CreateFile(taskPath + "/oom_adj", StrMerge("%d\n", oomScoreAdj * 17 / 1000));
+        CreateFile(taskPath + "/oom_score_adj", StrMerge("%d\n", oomScoreAdj));
+        CreateFile(taskPath + "/stat", StrMerge("%d (%s) S 1 1 0 0 -1 4194624 12345 0 0 0 %d %d 0 0 20 0 32 0 %d "
+            "15837184000 61234 18446744073709551615 1 1 0 0 0 0 4612 1 1073775864 0 0 0 17 3 0 0 0 0 0\n",
+            pid, FIXTURE_NAMES[idx % 8], idx * 3, idx, 100000 + idx));
+    }
+
+    return rootPath;
+}
+
+static void RemoveProcFixture_(const std::string &rootPath)
+{
+    static const char* const fileNames[] = { "cmdline", "oom_adj", "oom_score_adj", "stat" };
+    for (int idx = 0; idx < FIXTURE_PID_NUM; idx++) {
+        const auto &taskPath = StrMerge("%s/%d", rootPath.c_str(), FIXTURE_FIRST_PID + idx);
+        for (const auto &fileName : fileNames) {
+            unlink((taskPath + "/" + fileName).c_str());
+        }
+        rmdir(taskPath.c_str());
+    }
+    rmdir(rootPath.c_str());
+}
+
+static std::vector<int> GetLivePids_(void)
+{
+    std::vector<int> pids{};
+    DIR* dir = opendir("/proc");
+    if (dir) {
+        struct dirent* entry = nullptr;
+        while ((entry = readdir(dir)) != nullptr) {
+            int pid = atoi(entry->d_name);
+            if (pid > 0) {
+                pids.emplace_back(pid);
+            }
+        }
+        closedir(dir);
+    }
+
+    return pids;
+}
+
+static void StringBench_(void)
+{
+    std::string configText = "# CuBackgroundCtrl\nfreeze_grace_ms = 3000\nmin_frozen_ms = 10000\n";
+    for (int idx = 0; idx < 64; idx++) {
+        configText += StrMerge("com.example.app%d %s\n", idx, idx % 3 == 0 ? "strict" : "normal");
+    }
+    std::string procsText = "";
+    for (int idx = 0; idx < 1000; idx++) {
+        procsText += std::to_string(FIXTURE_FIRST_PID + idx * 397) + "\n";
+    }
+    const std::vector<std::string> integers = { "0", "7", "1000", "32768", "4194303", "-17\n", "15\n", "123456789" };
+    const std::vector<std::string> configLines = { "  freeze_grace_ms ", "\tcom.tencent.mm\r", "min_frozen_ms",
+        " com.example.app strict \n" };
+
+    const auto &splitConfigResult = BenchRun([&]() {
+        BenchKeep(StrSplit(configText, "\n").size());
+    }, 20000);
+    BenchReport("cu_misc/StrSplit/config_67_lines", splitConfigResult);
+
+    const auto &splitProcsResult = BenchRun([&]() {
+        BenchKeep(StrSplit(procsText, "\n").size());
+    }, 2000);
+    BenchReport("cu_misc/StrSplit/procs_1000_lines", splitProcsResult);
+
+    const auto &integerResult = BenchRun([&]() {
+        for (const auto &str : integers) {
+            BenchKeep(StringToInteger(str));
+        }
+    }, 200000);
+    BenchReport("cu_misc/StringToInteger", integerResult, integers.size());
+
+    const auto &trimResult = BenchRun([&]() {
+        for (const auto &line : configLines) {
+            BenchKeep(TrimStr(line).size());
+        }
+    }, 200000);
+    BenchReport("cu_misc/TrimStr", trimResult, configLines.size());
+
+    const auto &mergeResult = BenchRun([&]() {
+        BenchKeep(StrMerge("/proc/%d/cmdline", 12345).size());
+    }, 200000);
+    BenchReport("cu_misc/StrMerge/proc_path", mergeResult);
+
+    const auto &mergeLongResult = BenchRun([&]() {
+        BenchKeep(StrMerge("App \"%s\" uid=%d tasks=%zu since=%s\n", "com.tencent.mobileqq", 10234, (size_t)12,
+            "10-17 20:55:38").size());
+    }, 200000);
+    BenchReport("cu_misc/StrMerge/log_line", mergeLongResult);
+}
+
+static void ProcBench_(const std::string &rootPath)
+{
+    // GetTaskName() and GetTaskType() are hardwired to /proc, they run against the live pids of this system;
+    // ProcReader takes the fixture root and shows the same reads without the per-call path formatting and copies.
+    const auto &livePids = GetLivePids_();
+    if (!livePids.empty()) {
+        const auto &nameResult = BenchRun([&]() {
+            for (const int &pid : livePids) {
+                BenchKeep(GetTaskName(pid).size());
+            }
+        }, 20);
+        BenchReport(StrMerge("proc_live_%zu/GetTaskName", livePids.size()), nameResult, livePids.size());
+
+        const auto &typeResult = BenchRun([&]() {
+            for (const int &pid : livePids) {
+                BenchKeep(GetTaskType(pid));
+            }
+        }, 20);
+        BenchReport(StrMerge("proc_live_%zu/GetTaskType", livePids.size()), typeResult, livePids.size());
+    }
+
+    ProcReader procReader(rootPath);
+    const auto &readerNameResult = BenchRun([&]() {
+        ProcTaskInfo info{};
+        for (int idx = 0; idx < FIXTURE_PID_NUM; idx++) {
+            BenchKeep(procReader.ReadTask(FIXTURE_FIRST_PID + idx, PROC_READ_NAME, &info));
+        }
+    }, 20);
+    BenchReport(StrMerge("proc_fixture_%d/ProcReader/name", FIXTURE_PID_NUM), readerNameResult, FIXTURE_PID_NUM);
+
+    const auto &readerOomResult = BenchRun([&]() {
+        ProcTaskInfo info{};
+        for (int idx = 0; idx < FIXTURE_PID_NUM; idx++) {
+            BenchKeep(procReader.ReadTask(FIXTURE_FIRST_PID + idx, PROC_READ_OOM, &info));
+        }
+    }, 20);
+    BenchReport(StrMerge("proc_fixture_%d/ProcReader/oom", FIXTURE_PID_NUM), readerOomResult, FIXTURE_PID_NUM);
+
+    std::vector<std::string> cmdlinePaths{};
+    std::vector<std::string> statPaths{};
+    for (int idx = 0; idx < FIXTURE_PID_NUM; idx++) {
+        cmdlinePaths.emplace_back(StrMerge("%s/%d/cmdline", rootPath.c_str(), FIXTURE_FIRST_PID + idx));
+        statPaths.emplace_back(StrMerge("%s/%d/stat", rootPath.c_str(), FIXTURE_FIRST_PID + idx));
+    }
+    const auto &readFileResult = BenchRun([&]() {
+        for (const auto &path : cmdlinePaths) {
+            BenchKeep(ReadFile(path).size());
+        }
+    }, 20);
+    BenchReport(StrMerge("proc_fixture_%d/ReadFile/cmdline", FIXTURE_PID_NUM), readFileResult, FIXTURE_PID_NUM);
+
+    const auto &readFileExResult = BenchRun([&]() {
+        for (const auto &path : statPaths) {
+            BenchKeep(ReadFileEx(path).size());
+        }
+    }, 20);
+    BenchReport(StrMerge("proc_fixture_%d/ReadFileEx/stat", FIXTURE_PID_NUM), readFileExResult, FIXTURE_PID_NUM);
+}
+
+void CuMiscBench(void)
+{
+    StringBench_();
+
+    const auto &rootPath = CreateProcFixture_();
+    if (rootPath.empty()) {
+        fprintf(stderr, "CuMiscBench: failed to create the proc fixture.\n");
+        return;
+    }
+    ProcBench_(rootPath);
+    RemoveProcFixture_(rootPath);
+}
@@ -0,0 +1,69 @@
+#include <vector>
+#include "bench.h"
+#include "utils/cu_misc.h"
+#include "utils/file_reader.h"
+
+constexpr int PROCS_PID_NUM = 10000;
+
+static std::string CreateProcsFile_(void)
+{
+    char filePath[] = "/tmp/CuBenchProcsXXXXXX";
+    int fd = mkstemp(filePath);
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    std::string content = "";
+    for (int idx = 0; idx < PROCS_PID_NUM; idx++) {
+        content += std::to_string(1000 + idx * 397 % 4000000) + "\n";
+    }
+    WriteFile(filePath, content);
+
+    return filePath;
+}
+
+void FileReaderBench(void)
+{
+    const std::string filePath = CreateProcsFile_();
+
+    {
+        int pidNum = 0;
+        for (const auto &line : StrSplit(ReadFile(filePath), "\n")) {
+            if (StringToInteger(line) > 0) {
+                pidNum++;
+            }
+        }
+        fprintf(stderr, "FileReaderBench: ReadFile sees %d of %d pids.\n", pidNum, PROCS_PID_NUM);
+    }
+
+    const auto &splitResult = BenchRun([&]() {
+        int pidSum = 0;
+        for (const auto &line : StrSplit(ReadFileEx(filePath), "\n")) {
+            pidSum += StringToInteger(line);
+        }
+        BenchKeep(pidSum);
+    }, 200);
+    BenchReport("procs_10k/ReadFileEx+StrSplit", splitResult);
+
+    FileReader reader{};
+    const auto &readerResult = BenchRun([&]() {
+        int pidSum = 0;
+        reader.ForEachInteger(filePath, [&pidSum](const int &pid) {
+            pidSum += pid;
+        });
+        BenchKeep(pidSum);
+    }, 200);
+    BenchReport("procs_10k/FileReader::ForEachInteger", readerResult);
+
+    {
+        int pidNum = 0;
+        reader.ForEachInteger(filePath, [&pidNum](const int &) {
+            pidNum++;
+        });
+        if (pidNum != PROCS_PID_NUM) {
+            fprintf(stderr, "FileReaderBench: FileReader sees %d of %d pids.\n", pidNum, PROCS_PID_NUM);
+        }
+    }
+
+    unlink(filePath.c_str());
+}
@@ -0,0 +1,44 @@
+#include <regex>
+#include <vector>
+#include "bench.h"
+#include "utils/pkg_name.h"
+
+static const std::vector<std::string> &GetTaskNames_()
+{
+    static const std::vector<std::string> taskNames = {
+        "com.tencent.mm", "com.tencent.mm:push", "com.tencent.mm:appbrand0", "com.tencent.mobileqq",
+        "com.tencent.mobileqq:MSF", "com.android.systemui", "com.google.android.gms.persistent",
+        "com.google.android.gms:snet", "com.miui.home", "com.xiaomi.xmsf", "android.process.media",
+        "system_server", "zygote64", "<pre-initialized>", "/system/bin/surfaceflinger", "logd",
+        "com.android.providers.media.module", "com.ss.android.ugc.aweme:push", "com.taobao.taobao  ",
+        "com.eg.android.AlipayGphone\n", "webview_zygote", "com.example.", ".com.example", "a.b",
+    };
+
+    return taskNames;
+}
+
+void PkgNameBench(void)
+{
+    const auto &taskNames = GetTaskNames_();
+    const std::regex pkgNameRegex("^[\\w]+([.][\\w]+)+[\\s]*$");
+
+    for (const auto &taskName : taskNames) {
+        if (std::regex_search(taskName, pkgNameRegex) != IsPkgName(taskName)) {
+            fprintf(stderr, "PkgNameBench: mismatch on \"%s\".\n", taskName.c_str());
+        }
+    }
+
+    const auto &regexResult = BenchRun([&]() {
+        for (const auto &taskName : taskNames) {
+            BenchKeep(std::regex_search(taskName, pkgNameRegex));
+        }
+    }, 20000);
+    BenchReport("pkg_name/std_regex", regexResult, taskNames.size());
+
+    const auto &parseResult = BenchRun([&]() {
+        for (const auto &taskName : taskNames) {
+            BenchKeep(ParsePkgName(taskName).type);
+        }
+    }, 20000);
+    BenchReport("pkg_name/ParsePkgName", parseResult, taskNames.size());
+}
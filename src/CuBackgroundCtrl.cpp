@@ -1,6 +1,10 @@
 #include "CuBackgroundCtrl.h"
 
-CuBackgroundCtrl::CuBackgroundCtrl(const std::string &configPath) : configPath_(configPath), modules_() { }
+CuBackgroundCtrl::CuBackgroundCtrl(const std::string &configPath, const std::string &tracePath, const std::string &metricsPath) : 
+	configPath_(configPath), 
+	tracePath_(tracePath), 
+	metricsPath_(metricsPath), 
+	modules_() { }
 
 CuBackgroundCtrl::~CuBackgroundCtrl() { }
 
@@ -12,6 +16,7 @@ void CuBackgroundCtrl::Run()
 		const auto &logger = CuLogger::GetLogger();
 		logger->Error("The program encounters an error during runtime.");
 		logger->Error("Exception Thrown: %s", e.what());
+		logger->Flush();
 		std::exit(0);
 	}
 }
@@ -20,16 +25,25 @@ void CuBackgroundCtrl::Main_()
 {
 	const auto &logger = CuLogger::GetLogger();
 	
-	modules_.emplace_back(new BackgroundController(configPath_));
+	modules_.emplace_back(new BackgroundController(configPath_, tracePath_));
+	modules_.emplace_back(new ProcWatcher());
 	modules_.emplace_back(new ConfigWatcher(configPath_));
 	modules_.emplace_back(new CgroupWatcher());
+	modules_.emplace_back(new MetricsExporter(configPath_, metricsPath_));
 	for (const auto &module : modules_) {
 		module->Start();
 	}
+	if (!ControlServer::GetInstance()->Listen(CONTROL_SOCKET_NAME)) {
+		logger->Warning("Failed to open control socket.");
+	}
 
 	WriteFile("/dev/cpuset/system-background/cgroup.procs", StrMerge("%d\n", getpid()));
 	WriteFile("/dev/cpuctl/cgroup.procs", StrMerge("%d\n", getpid()));
 	WriteFile("/dev/stune/cgroup.procs", StrMerge("%d\n", getpid()));
 
 	logger->Info("Daemon Running (pid=%d).", getpid());
+
+	// Watchers, timers and pidfds are all served from this thread from now on.
+	Reactor::GetInstance()->Run();
+	logger->Error("Reactor stopped unexpectedly.");
 }
@@ -6,21 +6,27 @@
 
 #include "platform/module.h"
 #include "platform/singleton.h"
+#include "platform/reactor.h"
+#include "platform/control_server.h"
 #include "modules/cgroup_watcher.h"
 #include "modules/config_watcher.h"
+#include "modules/proc_watcher.h"
 #include "modules/background_controller.h"
+#include "modules/metrics_exporter.h"
 #include "utils/cu_misc.h"
 #include "utils/CuLogger.h"
 
 class CuBackgroundCtrl
 {
 	public:
-		CuBackgroundCtrl(const std::string &configPath);
+		CuBackgroundCtrl(const std::string &configPath, const std::string &tracePath, const std::string &metricsPath);
 		~CuBackgroundCtrl();
 		void Run();
 
 	private:
 		std::string configPath_;
+		std::string tracePath_;
+		std::string metricsPath_;
 		std::vector<Module*> modules_;
 
 		void Main_();
@@ -1,10 +1,19 @@
 #include "CuBackgroundCtrl.h"
 #include "utils/CuLogger.h"
 #include "utils/cu_misc.h"
+#include "utils/flight_recorder.h"
+#include "platform/control_server.h"
+#include <csignal>
 
 constexpr char DAEMON_NAME[] = "CuBackgroundCtrl";
 constexpr int MIN_KERNEL_VERSION = 318000;
 constexpr int MIN_ANDROID_SDK = 28;
+constexpr char CONTROL_USAGE[] = "Usage: CuBackgroundCtrl -C <command>\n"
+	"  list\n"
+	"  whitelist [list | add <rule> | remove <rule>]\n"
+	"  pass\n"
+	"  thaw <package>\n"
+	"  metrics\n";
 
 void ResetArgv(int argc, char* argv[])
 {
@@ -25,7 +34,7 @@ void KillOldDaemon()
 		while ((entry = readdir(dir)) != nullptr) {
 			if (IsPathExist(StrMerge("/proc/%s/cmdline", entry->d_name))) {
 				int taskPid = atoi(entry->d_name);
-				if (taskPid > 0 && taskPid < 32768) {
+				if (taskPid > 0) {
 					std::string taskName = GetTaskName(taskPid);
 					if (taskName == DAEMON_NAME && taskPid != myPid) {
 						kill(taskPid, SIGINT);
@@ -37,11 +46,26 @@ void KillOldDaemon()
 	}
 }
 
-void DaemonMain(const std::string &configPath)
+int ControlMain(const std::string &request)
+{
+	std::string response{};
+	if (!ControlServer::SendRequest(CONTROL_SOCKET_NAME, request, &response)) {
+		std::cout << "Daemon is not running." << std::endl;
+		return 1;
+	}
+	const auto &status = GetPrevString(response, '\n');
+	std::cout << GetPostString(response, '\n');
+
+	return status == "OK" ? 0 : 1;
+}
+
+void DaemonMain(const std::string &configPath, const std::string &tracePath, const std::string &metricsPath)
 {
 	daemon(0, 0);
 
 	const auto &logger = CuLogger::GetLogger();
+	// The writer thread is started here, threads don't survive the fork in daemon().
+	logger->StartWriter();
 	logger->Info("CuBackgroundCtrl V1 (%d) by chenzyadb.", GetCompileDateCode(__DATE__));
 
 	if (GetLinuxKernelVersion() < MIN_KERNEL_VERSION) {
@@ -55,7 +79,7 @@ void DaemonMain(const std::string &configPath)
 		std::exit(0);
 	}
 
-	CuBackgroundCtrl daemon(configPath);
+	CuBackgroundCtrl daemon(configPath, tracePath, metricsPath);
 	daemon.Run();
 
 	for (;;) {
@@ -68,8 +92,18 @@ int main(int argc, char* argv[])
 	std::string option = "";
 	std::string configPath = "";
 	std::string logPath = "";
-	if (argc == 2) {
+	std::string tracePath = "";
+	std::string request = "";
+	if (argc >= 3 && strcmp(argv[1], "-C") == 0) {
 		option = argv[1];
+		for (int i = 2; i < argc; i++) {
+			request += (i > 2 ? " " : "") + std::string(argv[i]);
+		}
+	} else if (argc == 2) {
+		option = argv[1];
+	} else if (argc == 3) {
+		option = argv[1];
+		tracePath = argv[2];
 	} else if (argc == 4) {
 		option = argv[1];
 		configPath = argv[2];
@@ -82,7 +116,19 @@ int main(int argc, char* argv[])
 		std::cout << "Daemon Start." << std::endl;
 		CuLogger::CreateLogger(CuLogger::LOG_DEBUG, logPath);
 		KillOldDaemon();
-		DaemonMain(configPath);
+		// The decision trace and the metrics snapshot live next to the log, "CuBackgroundCtrl -T <trace.bin>" prints the trace.
+		const auto &logDir = GetRePrevString(logPath, '/');
+		DaemonMain(configPath, logDir + "/trace.bin", logDir + "/metrics.prom");
+	} else if (option == "-C") {
+		if (request.empty()) {
+			std::cout << CONTROL_USAGE;
+			return 1;
+		}
+		return ControlMain(request);
+	} else if (option == "-T" && argc == 3) {
+		if (!FlightRecorder::Dump(tracePath, stdout)) {
+			std::cout << "Invalid trace file." << std::endl;
+		}
 	} else {
 		std::cout << "Wrong Input." << std::endl;
 	}
@@ -9,142 +9,676 @@ constexpr int POLICY_DEFAULT = 0;
 constexpr int POLICY_NORMAL = 1;
 constexpr int POLICY_STRICT = 2;
 
-BackgroundController::BackgroundController(const std::string &configPath) : 
+// What each policy does with an app of each task type: kill it, freeze it or leave it running.
+// The POLICY_DEFAULT row is a placeholder, CompileDecisions_() fills it with the row of default_policy.
+constexpr int8_t POLICY_STATES[POLICY_NUM][TASK_TYPE_NUM] = {
+    // TASK_OTHER, TASK_FOREGROUND, TASK_VISIBLE, TASK_SERVICE, TASK_SYSTEM, TASK_BACKGROUND, TASK_KILLABLE
+    {STATE_FOREGROUND, STATE_FOREGROUND, STATE_FOREGROUND, STATE_FOREGROUND, STATE_FOREGROUND, STATE_FOREGROUND, STATE_FOREGROUND},
+    {STATE_FOREGROUND, STATE_FOREGROUND, STATE_FOREGROUND, STATE_FOREGROUND, STATE_FOREGROUND, STATE_FOREGROUND, STATE_FOREGROUND},
+    {STATE_FOREGROUND, STATE_FOREGROUND, STATE_FOREGROUND, STATE_FOREGROUND, STATE_FOREGROUND, STATE_BACKGROUND, STATE_KILLED},
+    {STATE_FOREGROUND, STATE_FOREGROUND, STATE_FOREGROUND, STATE_BACKGROUND, STATE_FOREGROUND, STATE_BACKGROUND, STATE_KILLED},
+};
+constexpr const char* POLICY_NAMES[POLICY_NUM] = {"whitelist", "default", "normal", "strict"};
+
+constexpr size_t MAX_PENDING_TASK_EVENTS = 4096;
+
+constexpr uint64_t WAKEUP_LEADING_MS = 10;
+constexpr uint64_t WAKEUP_TRAILING_MS = 100;
+constexpr uint64_t WAKEUP_MAX_LATENCY_MS = 500;
+constexpr uint64_t WAKEUP_STATS_PASSES = 200;
+
+constexpr uint64_t FREEZE_TIMER_TICK_MS = 100;
+constexpr size_t FREEZE_TIMER_SLOTS = 512;
+constexpr int FREEZE_TIMER_GRACE = 0;
+constexpr int FREEZE_TIMER_MIN_FROZEN = 1;
+constexpr int FREEZE_MAX_RETRIES = 2;
+
+constexpr uint64_t DEFAULT_FREEZE_GRACE_MS = 3000;
+constexpr uint64_t DEFAULT_MIN_FROZEN_MS = 10000;
+constexpr int64_t MAX_CONFIG_TIME_MS = 24 * 3600 * 1000;
+
+BackgroundController::BackgroundController(const std::string &configPath, const std::string &tracePath) : 
     Module(), 
-    pkgNameRegex_("^[\\w]+([.][\\w]+)+[\\s]*$"),
     configPath_(configPath),
-    whiteList_(),
+    tracePath_(tracePath),
+    config_(),
+    configMtx_(),
+    procReader_(),
+    processTable_(&procReader_),
+    procsReader_(),
+    pendingTaskEvents_(),
+    pendingThaws_(),
+    procEventDriven_(false),
+    procStateChanged_(false),
+    eventMtx_(),
+    taskWatcher_(),
+    freezer_(),
+    frozenApps_(),
+    frozenTasks_(),
+    frozenPids_(),
+    killedApps_(),
+    tasksMtx_(),
+    status_(std::make_shared<StatusSnapshot>()),
     logger_(CuLogger::GetLogger()),
+    metrics_(Metrics::GetInstance()),
+    flightRecorder_(),
     thread_(),
-    cv_(),
-    mtx_(),
-    unblocked_(false) { }
+    wakeup_(WAKEUP_LEADING_MS, WAKEUP_TRAILING_MS, WAKEUP_MAX_LATENCY_MS),
+    freezeTimers_(FREEZE_TIMER_TICK_MS, FREEZE_TIMER_SLOTS),
+    graceTimers_(),
+    passCount_(0),
+    passCgroupModifiedUs_(0),
+    cgroupModifiedUs_(0),
+    ioFd_(-1)
+{
+    auto config = std::make_shared<ConfigSnapshot>();
+    config->freezeGraceMs = DEFAULT_FREEZE_GRACE_MS;
+    config->minFrozenMs = DEFAULT_MIN_FROZEN_MS;
+    config->defaultPolicy = POLICY_NORMAL;
+    CompileDecisions_(config.get());
+    config_ = std::move(config);
+}
 
 BackgroundController::~BackgroundController() { }
 
 void BackgroundController::Start() 
 {
     LoadConfig_();
+    if (!flightRecorder_.Open(tracePath_)) {
+        logger_->Warning("Failed to open trace file \"%s\".", tracePath_.c_str());
+    }
+    {
+        using namespace std::placeholders;
+        if (taskWatcher_.Init(std::bind(&BackgroundController::TaskExited_, this, _1))) {
+            logger_->Info("Task exits are tracked through pidfd.");
+        } else {
+            logger_->Warning("pidfd is not supported, fall back to kill().");
+        }
+    }
+    {
+        freezer_.Init(&taskWatcher_);
+        int backend = freezer_.GetBackend();
+        if (backend == FREEZER_CGROUP_V2) {
+            logger_->Info("Freezer backend: cgroup v2.");
+        } else if (backend == FREEZER_CGROUP_V1) {
+            logger_->Info("Freezer backend: cgroup v1.");
+        } else {
+            logger_->Info("Freezer backend: SIGSTOP.");
+        }
+    }
     {
-        unblocked_ = false;
         thread_ = std::thread(std::bind(&BackgroundController::ControllerMain_, this));
         thread_.detach();
     }
     Timer_AddTimer("BackgroundController.Reflash", std::bind(&BackgroundController::Reflash_, this), 5000);
     {
         using namespace std::placeholders;
-        Broadcast_SetBroadcastReceiver("CgroupWatcher.TopAppCgroupModified", std::bind(&BackgroundController::CgroupModified_, this, _1));
-        Broadcast_SetBroadcastReceiver("CgroupWatcher.ForegroundCgroupModified", std::bind(&BackgroundController::CgroupModified_, this, _1));
-        Broadcast_SetBroadcastReceiver("CgroupWatcher.BackgroundCgroupModified", std::bind(&BackgroundController::CgroupModified_, this, _1));
-        Broadcast_SetBroadcastReceiver("CgroupWatcher.ScreenStateChanged", std::bind(&BackgroundController::ScreenStateChanged_, this, _1));
-        Broadcast_SetBroadcastReceiver("ConfigWatcher.ConfigModified", std::bind(&BackgroundController::ConfigModified_, this, _1));
+        EventBus_Subscribe<TopAppCgroupModifiedTopic>(std::bind(&BackgroundController::CgroupModified_, this, _1));
+        EventBus_Subscribe<ForegroundCgroupModifiedTopic>(std::bind(&BackgroundController::CgroupModified_, this, _1));
+        EventBus_Subscribe<BackgroundCgroupModifiedTopic>(std::bind(&BackgroundController::CgroupModified_, this, _1));
+        EventBus_Subscribe<ScreenStateChangedTopic>(std::bind(&BackgroundController::ScreenStateChanged_, this, _1));
+        EventBus_Subscribe<ConfigModifiedTopic>(std::bind(&BackgroundController::ConfigModified_, this, _1));
+        EventBus_Subscribe<ProcStateChangedTopic>(std::bind(&BackgroundController::ProcStateChanged_, this, _1));
+        EventBus_Subscribe<TaskChangedTopic>(std::bind(&BackgroundController::TaskChanged_, this, _1));
+    }
+    {
+        using namespace std::placeholders;
+        Control_RegisterCommand("list", std::bind(&BackgroundController::ListCommand_, this, _1, _2));
+        Control_RegisterCommand("whitelist", std::bind(&BackgroundController::WhitelistCommand_, this, _1, _2));
+        Control_RegisterCommand("pass", std::bind(&BackgroundController::PassCommand_, this, _1, _2));
+        Control_RegisterCommand("thaw", std::bind(&BackgroundController::ThawCommand_, this, _1, _2));
     }
 }
 
 void BackgroundController::ControllerMain_()
 {
     SetThreadName("ControllerMain");
+    // The per-thread io accounting counts this thread's read and write family syscalls.
+    ioFd_ = open(StrMerge("/proc/self/task/%d/io", gettid()).c_str(), O_RDONLY | O_CLOEXEC);
 
-    std::vector<int> freezedTasks{};
     for (;;) {
         {
-            std::unique_lock<std::mutex> lck(mtx_);
-            while (!unblocked_) {
-                cv_.wait(lck);
+            const auto &action = wakeup_.Wait(freezeTimers_.GetNextDeadlineMs());
+            const auto &stats = wakeup_.GetStats();
+            if (action.eventNum > 0 && stats.actionNum % WAKEUP_STATS_PASSES == 0) {
+                CU_LOGD("Controller wakeups: %llu passes for %llu events, avg latency %llums, max latency %llums.", 
+                    (unsigned long long)stats.actionNum, (unsigned long long)stats.eventNum, 
+                    (unsigned long long)(stats.totalLatencyMs / stats.actionNum), (unsigned long long)stats.maxLatencyMs);
             }
-            unblocked_ = false;
         }
+        uint64_t passStartUs = GetTimeStampUs();
+        uint64_t passStartSyscallNum = GetIoSyscallNum_();
+        uint64_t cgroupModifiedUs = cgroupModifiedUs_.exchange(0);
+        std::vector<std::string> thawRequests{};
         {
-            std::unordered_map<int, std::string> backgroundTasks{};
+            std::vector<TaskEvent> taskEvents{};
             {
-                const auto &lines = StrSplit(ReadFile("/dev/cpuset/background/cgroup.procs"), "\n");
-                for (const auto &line : lines) {
-                    int pid = StringToInteger(line);
-                    if (pid > 0 && pid < 32768) {
-                        backgroundTasks[pid] = GetTaskName(pid);
-                    }
+                std::unique_lock<std::mutex> lck(eventMtx_);
+                taskEvents.swap(pendingTaskEvents_);
+                thawRequests.swap(pendingThaws_);
+                if (procStateChanged_) {
+                    processTable_.SetEventDriven(procEventDriven_);
+                    procStateChanged_ = false;
                 }
             }
-        
-            std::vector<std::string> needKillApps{};
-            std::vector<std::string> needFreezeApps{};
-            for (const auto &[pid, taskName] : backgroundTasks) {
-                if (std::regex_search(taskName, pkgNameRegex_)) {
-                    if (std::find(whiteList_.begin(), whiteList_.end(), taskName) == whiteList_.end()) {
-                        int taskType = GetTaskType(pid);
-                        if (taskType == TASK_KILLABLE) {
-                            needKillApps.emplace_back(taskName);
-                        } else if (taskType == TASK_BACKGROUND) {
-                            needFreezeApps.emplace_back(taskName);
-                        }
+            for (const auto &event : taskEvents) {
+                processTable_.ApplyEvent(event);
+            }
+        }
+        {
+            uint64_t pidNum = 0;
+            processTable_.BeginPass();
+            procsReader_.ForEachInteger("/dev/cpuset/background/cgroup.procs", [this, &pidNum](const int &pid) {
+                if (pid > 0) {
+                    processTable_.UpdateTask(pid);
+                    pidNum++;
+                }
+            });
+            processTable_.EndPass();
+            metrics_->AddCounter(METRIC_CONTROLLER_PIDS_SCANNED, pidNum);
+        }
+        const auto &backgroundTasks = processTable_.GetTasks();
+
+        // One snapshot for the whole pass, a reload in the middle of it takes effect on the next one.
+        const auto &config = GetConfig_();
+        std::unordered_map<std::string_view, AppTasks> backgroundApps{};
+        for (const auto &[pid, taskInfo] : backgroundTasks) {
+            const auto &pkgNameInfo = taskInfo.pkgNameInfo;
+            if (pkgNameInfo.type != PKG_NAME_INVALID) {
+                std::string_view pkgName(taskInfo.taskName.data(), pkgNameInfo.pkgNameLen);
+                int policy = config->defaultPolicy;
+                config->policyRules.Find(pkgName, &policy);
+                if (policy != POLICY_WHITELIST) {
+                    auto &app = backgroundApps[pkgName];
+                    app.policy = policy;
+                    app.pids.emplace_back(pid);
+                    if (pkgNameInfo.type == PKG_NAME_APP) {
+                        app.mainPid = pid;
+                        app.uid = taskInfo.uid;
                     }
                 }
             }
+        }
 
-            for (const auto &pkgName : needKillApps) {
-                for (const auto &[pid, taskName] : backgroundTasks) {
-                    if (StrContains(taskName, pkgName)) {
-                        kill(pid, SIGKILL);
-                        const auto &iter = std::find(freezedTasks.begin(), freezedTasks.end(), pid);
-                        if (iter != freezedTasks.end()) {
-                            freezedTasks.erase(iter);
-                        }
-                    }
+        uint64_t nowMs = GetTimeStampMs();
+        passCount_++;
+        freezeTimers_.Advance(nowMs, [this](const std::string &pkgName, const int &tag) {
+            if (tag == FREEZE_TIMER_GRACE) {
+                const auto &iter = graceTimers_.find(pkgName);
+                if (iter != graceTimers_.end()) {
+                    iter->second.expired = true;
                 }
             }
-            {
-                auto prevFreezedTasks = freezedTasks;
-                freezedTasks.clear();
-                for (const auto &pkgName : needFreezeApps) {
-                    for (const auto &[pid, taskName] : backgroundTasks) {
-                        if (StrContains(taskName, pkgName)) {
-                            kill(pid, SIGSTOP);
-                            freezedTasks.emplace_back(pid);
-                        }
+        });
+
+        std::unique_lock<std::mutex> lck(tasksMtx_);
+        // Thaws requested through the control socket or a config change, before the pass may refreeze the app.
+        for (const auto &pkgName : thawRequests) {
+            if (ThawFrozenApp_(pkgName)) {
+                logger_->Info("Thawed \"%s\" on request.", pkgName.c_str());
+            }
+        }
+        passCgroupModifiedUs_ = cgroupModifiedUs;
+        std::unordered_map<std::string, FrozenApp> needFreezeApps{};
+        for (auto &[pkgName, app] : backgroundApps) {
+            if (app.mainPid < 0) {
+                continue;
+            }
+            ProcTaskInfo procTaskInfo{};
+            if (!procReader_.ReadTask(app.mainPid, PROC_READ_OOM, &procTaskInfo)) {
+                continue;
+            }
+            app.oomAdj = procTaskInfo.oomAdj;
+            app.taskType = OomAdjToTaskType(app.oomAdj);
+            app.state = config->decisions[app.policy - POLICY_WHITELIST][app.taskType - TASK_OTHER];
+            if (app.state == STATE_KILLED) {
+                auto &killedApp = killedApps_[std::string(pkgName)];
+                killedApp.uid = app.uid;
+                killedApp.killedAtMs = nowMs;
+                killedApp.killNum++;
+                for (const int &pid : app.pids) {
+                    // The pidfd is opened and checked against the starttime read in this pass, a reused pid is left alone.
+                    int sig = 0;
+                    if (taskWatcher_.SendSignal(pid, backgroundTasks.at(pid).startTime, SIGKILL) == 0) {
+                        sig = SIGKILL;
+                        metrics_->AddCounter(METRIC_CONTROLLER_KILLS);
                     }
+                    flightRecorder_.Record(passCount_, pid, app.uid, app.oomAdj, app.taskType, TRACE_DECISION_KILL, sig);
                 }
-                for (const int &pid : prevFreezedTasks) {
-                    if (std::find(freezedTasks.begin(), freezedTasks.end(), pid) == freezedTasks.end()) {
-                        kill(pid, SIGCONT);
-                    }
+            } else if (app.state == STATE_BACKGROUND) {
+                std::string pkgNameStr(pkgName);
+                if (IsFreezeDue_(pkgNameStr, nowMs, *config)) {
+                    // Recorded per pid by FreezeApp_() once UpdateFrozenApps_() knows which pids it touches.
+                    auto &frozenApp = needFreezeApps[pkgNameStr];
+                    frozenApp.uid = app.uid;
+                    frozenApp.oomAdj = app.oomAdj;
+                    frozenApp.taskType = app.taskType;
+                    frozenApp.pids = app.pids;
+                } else {
+                    flightRecorder_.Record(passCount_, app.mainPid, app.uid, app.oomAdj, app.taskType, TRACE_DECISION_GRACE, 0);
+                }
+            } else {
+                flightRecorder_.Record(passCount_, app.mainPid, app.uid, app.oomAdj, app.taskType, TRACE_DECISION_NONE, 0);
+            }
+        }
+        for (auto iter = graceTimers_.begin(); iter != graceTimers_.end();) {
+            if (iter->second.passCount != passCount_) {
+                freezeTimers_.Cancel(iter->second.timerId);
+                iter = graceTimers_.erase(iter);
+            } else {
+                iter++;
+            }
+        }
+        // Apps that stay in the background cgroup are kept frozen for at least minFrozenMs,
+        // so a short oom_adj bump doesn't thaw and refreeze them.
+        for (const auto &[pkgName, frozenApp] : frozenApps_) {
+            if (needFreezeApps.count(pkgName) == 0 && nowMs < frozenApp.frozenAtMs + config->minFrozenMs) {
+                auto appIter = backgroundApps.find(pkgName);
+                if (appIter != backgroundApps.end() && appIter->second.mainPid >= 0 && 
+                    appIter->second.state != STATE_KILLED) {
+                    auto &app = appIter->second;
+                    auto &keptApp = needFreezeApps[pkgName];
+                    keptApp.uid = app.uid;
+                    keptApp.oomAdj = app.oomAdj;
+                    keptApp.taskType = app.taskType;
+                    keptApp.pids = app.pids;
+                    flightRecorder_.Record(passCount_, app.mainPid, app.uid, app.oomAdj, app.taskType, TRACE_DECISION_KEEP, 0);
+                }
+            }
+        }
+        UpdateFrozenApps_(needFreezeApps, backgroundTasks, nowMs, *config);
+        passCgroupModifiedUs_ = 0;
+        PublishStatus_();
+        lck.unlock();
+
+        metrics_->AddCounter(METRIC_CONTROLLER_PASSES);
+        metrics_->Observe(METRIC_CONTROLLER_PASS_DURATION, GetTimeStampUs() - passStartUs);
+        if (passStartSyscallNum > 0) {
+            // The read that took passStartSyscallNum is counted in the second sample as well.
+            metrics_->Observe(METRIC_CONTROLLER_PASS_IO_SYSCALLS, GetIoSyscallNum_() - passStartSyscallNum - 1);
+        }
+    }
+}
+
+uint64_t BackgroundController::GetIoSyscallNum_()
+{
+    uint64_t syscallNum = 0;
+    if (ioFd_ >= 0) {
+        char buffer[512] = { 0 };
+        ssize_t len = pread(ioFd_, buffer, sizeof(buffer) - 1, 0);
+        if (len > 0) {
+            buffer[len] = '\0';
+            const char* syscr = strstr(buffer, "syscr: ");
+            const char* syscw = strstr(buffer, "syscw: ");
+            if (syscr != nullptr && syscw != nullptr) {
+                syscallNum = strtoull(syscr + 7, nullptr, 10) + strtoull(syscw + 7, nullptr, 10);
+            }
+        }
+    }
+
+    return syscallNum;
+}
+
+void BackgroundController::FreezeApp_(const FrozenApp &app, const std::vector<int> &pids)
+{
+    freezer_.FreezeApp(app.uid, pids, [this, &app](const int &pid, const int &sig) {
+        flightRecorder_.Record(passCount_, pid, app.uid, app.oomAdj, app.taskType, TRACE_DECISION_FREEZE, sig);
+    });
+}
+
+void BackgroundController::ThawApp_(const int &uid, const std::vector<int> &pids, const uint64_t &passId)
+{
+    freezer_.ThawApp(uid, pids, [this, &uid, &passId](const int &pid, const int &sig) {
+        flightRecorder_.Record(passId, pid, uid, TRACE_OOM_ADJ_UNKNOWN, TASK_OTHER, TRACE_DECISION_THAW, sig);
+    });
+    metrics_->AddCounter(METRIC_CONTROLLER_THAWS);
+    // Only the first thaw of a pass is measured, that is the one the cgroup change was waiting for.
+    if (passCgroupModifiedUs_ > 0) {
+        metrics_->Observe(METRIC_CGROUP_TO_THAW_LATENCY, GetTimeStampUs() - passCgroupModifiedUs_);
+        passCgroupModifiedUs_ = 0;
+    }
+}
+
+bool BackgroundController::IsFreezeDue_(const std::string &pkgName, const uint64_t &nowMs, const ConfigSnapshot &config)
+{
+    const uint64_t &freezeGraceMs = config.freezeGraceMs;
+    if (frozenApps_.count(pkgName) == 1 || freezeGraceMs == 0) {
+        return true;
+    }
+
+    bool due = false;
+    const auto &iter = graceTimers_.find(pkgName);
+    if (iter == graceTimers_.end()) {
+        GraceTimer graceTimer{};
+        graceTimer.timerId = freezeTimers_.Schedule(nowMs + freezeGraceMs, pkgName, FREEZE_TIMER_GRACE);
+        graceTimer.passCount = passCount_;
+        graceTimers_.emplace(pkgName, graceTimer);
+    } else if (iter->second.expired) {
+        graceTimers_.erase(iter);
+        due = true;
+    } else {
+        iter->second.passCount = passCount_;
+    }
+
+    return due;
+}
+
+void BackgroundController::UpdateFrozenApps_(std::unordered_map<std::string, FrozenApp> &needFreezeApps, 
+    const std::unordered_map<int, ProcessTable::TaskInfo> &tasks, const uint64_t &nowMs, const ConfigSnapshot &config)
+{
+    PidSet needFreezePids{};
+    for (const auto &[pkgName, app] : needFreezeApps) {
+        for (const int &pid : app.pids) {
+            needFreezePids.Insert(pid);
+        }
+    }
+    std::vector<int> leftPids{};
+    frozenPids_.ForEachDifference(needFreezePids, [&leftPids](const int &pid) {
+        leftPids.emplace_back(pid);
+    });
+
+    // Thawing after the kills also lets killed tasks of a frozen cgroup exit.
+    for (const auto &[pkgName, frozenApp] : frozenApps_) {
+        if (needFreezeApps.count(pkgName) == 0) {
+            ThawApp_(frozenApp.uid, frozenApp.pids, passCount_);
+        }
+    }
+    for (auto &[pkgName, app] : needFreezeApps) {
+        const auto &iter = frozenApps_.find(pkgName);
+        if (iter == frozenApps_.end()) {
+            WatchTasks_(pkgName, app.pids, tasks);
+            FreezeApp_(app, app.pids);
+            metrics_->AddCounter(METRIC_CONTROLLER_FREEZES);
+            app.frozenAtMs = nowMs;
+            const uint64_t &minFrozenMs = config.minFrozenMs;
+            if (minFrozenMs > 0) {
+                freezeTimers_.Schedule(nowMs + minFrozenMs, pkgName, FREEZE_TIMER_MIN_FROZEN);
+            }
+            continue;
+        }
+        app.frozenAtMs = iter->second.frozenAtMs;
+        const auto &prevPids = iter->second.pids;
+        bool taskLeft = false;
+        bool taskAlive = false;
+        for (const int &pid : prevPids) {
+            if (!needFreezePids.Contains(pid)) {
+                taskLeft = true;
+                if (kill(pid, 0) == 0) {
+                    taskAlive = true;
+                    break;
+                }
+            }
+        }
+        std::vector<int> joinedPids{};
+        for (const int &pid : app.pids) {
+            if (!frozenPids_.Contains(pid)) {
+                joinedPids.emplace_back(pid);
+            }
+        }
+        if (taskAlive) {
+            // A task left the background cgroup while its app stays frozen.
+            ThawApp_(iter->second.uid, prevPids, passCount_);
+            WatchTasks_(pkgName, joinedPids, tasks);
+            FreezeApp_(app, app.pids);
+        } else if (taskLeft || joinedPids.size() > 0) {
+            WatchTasks_(pkgName, joinedPids, tasks);
+            FreezeApp_(app, joinedPids);
+        } else {
+            app.confirmed = iter->second.confirmed;
+            app.freezeRetries = iter->second.freezeRetries;
+            if (!app.confirmed) {
+                // A freeze the cgroup never completes is written again, then the tasks are SIGSTOPped instead.
+                if (freezer_.IsAppFrozen(app.uid, app.pids)) {
+                    app.confirmed = true;
+                } else if (app.freezeRetries < FREEZE_MAX_RETRIES) {
+                    CU_LOGD("App \"%s\" is still freezing, freezing it again.", pkgName.c_str());
+                    app.freezeRetries++;
+                    FreezeApp_(app, app.pids);
+                } else {
+                    logger_->Warning("App \"%s\" doesn't freeze, stopping it with SIGSTOP.", pkgName.c_str());
+                    freezer_.StopApp(app.pids, [this, &app](const int &pid, const int &sig) {
+                        flightRecorder_.Record(passCount_, pid, app.uid, app.oomAdj, app.taskType, TRACE_DECISION_FREEZE, sig);
+                    });
+                    app.confirmed = true;
                 }
             }
         }
+    }
+    UnwatchTasks_(leftPids);
+    frozenApps_ = std::move(needFreezeApps);
+}
 
-        usleep(500000);
+void BackgroundController::WatchTasks_(const std::string &pkgName, const std::vector<int> &pids, 
+    const std::unordered_map<int, ProcessTable::TaskInfo> &tasks)
+{
+    for (const int &pid : pids) {
+        frozenTasks_[pid] = pkgName;
+        frozenPids_.Insert(pid);
+        const auto &iter = tasks.find(pid);
+        if (iter != tasks.end()) {
+            taskWatcher_.WatchTask(pid, iter->second.startTime);
+        }
+    }
+}
+
+void BackgroundController::UnwatchTasks_(const std::vector<int> &pids)
+{
+    for (const int &pid : pids) {
+        frozenTasks_.erase(pid);
+        frozenPids_.Erase(pid);
+        taskWatcher_.UnwatchTask(pid);
+        freezer_.ForgetTask(pid);
     }
 }
 
 void BackgroundController::LoadConfig_()
 {
-    whiteList_.clear();
+    // Parsed off the hot path into a private snapshot, the controller only sees it once it is complete.
+    auto config = std::make_shared<ConfigSnapshot>();
+    config->freezeGraceMs = DEFAULT_FREEZE_GRACE_MS;
+    config->minFrozenMs = DEFAULT_MIN_FROZEN_MS;
+    config->defaultPolicy = POLICY_NORMAL;
     const auto &lines = StrSplit(ReadFileEx(configPath_), "\n");
     for (const auto &line : lines) {
-        if (std::regex_search(line, pkgNameRegex_)) {
-            whiteList_.emplace_back(TrimStr(line));
+        std::string content = StripConfigComment(line);
+        if (TrimStr(content).empty()) {
+            continue;
+        }
+        if (StrContains(content, "=")) {
+            const auto &key = TrimStr(GetPrevString(content, '='));
+            const auto &value = TrimStr(GetPostString(content, '='));
+            int64_t integer = 0;
+            if (key == "freeze_grace_ms" || key == "min_frozen_ms") {
+                if (!StringToInt64(GetPostString(content, '='), &integer) || integer < 0 || integer > MAX_CONFIG_TIME_MS) {
+                    logger_->Warning("Invalid value \"%s\" for \"%s\", ignored.", value.c_str(), key.c_str());
+                } else if (key == "freeze_grace_ms") {
+                    config->freezeGraceMs = (uint64_t)integer;
+                } else {
+                    config->minFrozenMs = (uint64_t)integer;
+                }
+            } else if (key == "default_policy") {
+                int policy = GetPolicy_(value);
+                if (policy != POLICY_DEFAULT) {
+                    config->defaultPolicy = policy;
+                } else {
+                    logger_->Warning("Invalid default policy \"%s\".", value.c_str());
+                }
+            } else if (StrContains(key, "metrics_")) {
+                // Handled by MetricsExporter.
+            } else {
+                logger_->Warning("Unknown config option \"%s\".", key.c_str());
+            }
+        } else {
+            // "<package or wildcard> <policy>", a rule without a policy is a whitelist entry as before.
+            std::replace_if(content.begin(), content.end(), [](const char &c) {
+                return c == '\t' || c == '\r';
+            }, ' ');
+            std::vector<std::string> fields{};
+            for (const auto &field : StrSplit(content, " ")) {
+                if (!field.empty()) {
+                    fields.emplace_back(field);
+                }
+            }
+            const auto &rule = fields[0];
+            const std::string policyName = fields.size() > 1 ? fields[1] : "";
+            int policy = policyName.empty() ? POLICY_WHITELIST : GetPolicy_(policyName);
+            if (fields.size() > 2) {
+                logger_->Warning("Invalid rule line \"%s\".", content.c_str());
+            } else if (policy == POLICY_DEFAULT && policyName != POLICY_NAMES[POLICY_DEFAULT - POLICY_WHITELIST]) {
+                logger_->Warning("Unknown policy \"%s\" for \"%s\".", policyName.c_str(), rule.c_str());
+            } else if (!config->policyRules.AddRule(rule, policy)) {
+                logger_->Warning("Invalid rule \"%s\".", rule.c_str());
+            }
+        }
+    }
+    CompileDecisions_(config.get());
+
+    std::shared_ptr<const ConfigSnapshot> prevConfig = nullptr;
+    {
+        // Whitelist changes made through the control socket only last until the config file is reloaded.
+        std::unique_lock<std::mutex> lck(configMtx_);
+        prevConfig = GetConfig_();
+        PublishConfig_(config);
+    }
+    ApplyConfigDelta_(*prevConfig, *config);
+}
+
+void BackgroundController::ApplyConfigDelta_(const ConfigSnapshot &prevConfig, const ConfigSnapshot &config)
+{
+    // Only what differs from the previous snapshot is logged and acted on.
+    size_t changeNum = 0;
+    if (config.freezeGraceMs != prevConfig.freezeGraceMs || config.minFrozenMs != prevConfig.minFrozenMs || 
+        config.defaultPolicy != prevConfig.defaultPolicy) {
+        logger_->Info("Freeze grace period: %llums, min frozen time: %llums, default policy: %s.", 
+            (unsigned long long)config.freezeGraceMs, (unsigned long long)config.minFrozenMs, 
+            POLICY_NAMES[config.defaultPolicy - POLICY_WHITELIST]);
+        changeNum++;
+    }
+    {
+        std::unordered_map<std::string, int> prevRules{};
+        for (const auto &[rule, policy] : prevConfig.policyRules.GetRules()) {
+            prevRules.emplace(rule, policy);
         }
+        for (const auto &[rule, policy] : config.policyRules.GetRules()) {
+            const auto &iter = prevRules.find(rule);
+            if (iter == prevRules.end()) {
+                logger_->Info("Policy added: \"%s\" %s.", rule.c_str(), POLICY_NAMES[policy - POLICY_WHITELIST]);
+                changeNum++;
+            } else {
+                if (iter->second != policy) {
+                    logger_->Info("Policy changed: \"%s\" %s -> %s.", rule.c_str(), 
+                        POLICY_NAMES[iter->second - POLICY_WHITELIST], POLICY_NAMES[policy - POLICY_WHITELIST]);
+                    changeNum++;
+                }
+                prevRules.erase(iter);
+            }
+        }
+        for (const auto &[rule, policy] : prevRules) {
+            logger_->Info("Policy removed: \"%s\" %s.", rule.c_str(), POLICY_NAMES[policy - POLICY_WHITELIST]);
+            changeNum++;
+        }
+    }
+    if (changeNum == 0) {
+        return;
     }
-    logger_->Info("Config updated.");
-    for (const auto &item : whiteList_) {
-        logger_->Info("WhiteList: \"%s\".", item.c_str());
+    logger_->Info("Config updated, %zu changes.", changeNum);
+
+    // Frozen apps that became whitelisted are thawed first thing in the pass started now instead of at the
+    // next Reflash_, the pass also applies everything else a changed policy or threshold can affect.
+    const auto &status = std::atomic_load(&status_);
+    for (const auto &[pkgName, frozenApp] : status->frozenApps) {
+        int policy = config.defaultPolicy;
+        config.policyRules.Find(pkgName, &policy);
+        if (policy == POLICY_WHITELIST) {
+            logger_->Info("Thawing \"%s\", it is whitelisted now.", pkgName.c_str());
+            RequestThaw_(pkgName);
+        }
     }
+    wakeup_.Notify();
+}
+
+void BackgroundController::CompileDecisions_(ConfigSnapshot* config)
+{
+    memcpy(config->decisions, POLICY_STATES, sizeof(config->decisions));
+    memcpy(config->decisions[POLICY_DEFAULT - POLICY_WHITELIST], POLICY_STATES[config->defaultPolicy - POLICY_WHITELIST], 
+        sizeof(config->decisions[0]));
 }
 
-void BackgroundController::ConfigModified_(const void* data)
+int BackgroundController::GetPolicy_(const std::string &policyName)
+{
+    int policy = POLICY_DEFAULT;
+    for (int idx = 0; idx < POLICY_NUM; idx++) {
+        if (policyName == POLICY_NAMES[idx]) {
+            policy = idx + POLICY_WHITELIST;
+            break;
+        }
+    }
+
+    return policy;
+}
+
+void BackgroundController::ConfigModified_(const uint32_t &)
 {
     LoadConfig_();
 }
 
-void BackgroundController::CgroupModified_(const void* data)
+void BackgroundController::TaskExited_(int pid)
+{
+    std::unique_lock<std::mutex> lck(tasksMtx_);
+    freezer_.ForgetTask(pid);
+    if (!frozenPids_.Erase(pid)) {
+        return;
+    }
+    const auto &iter = frozenTasks_.find(pid);
+    if (iter == frozenTasks_.end()) {
+        return;
+    }
+    const auto &appIter = frozenApps_.find(iter->second);
+    if (appIter != frozenApps_.end()) {
+        auto &pids = appIter->second.pids;
+        const auto &pidIter = std::find(pids.begin(), pids.end(), pid);
+        if (pidIter != pids.end()) {
+            pids.erase(pidIter);
+        }
+        if (pids.empty()) {
+            // Don't leave an empty uid cgroup frozen, the app would start frozen next time.
+            ThawApp_(appIter->second.uid, pids, 0);
+            flightRecorder_.Record(0, pid, appIter->second.uid, TRACE_OOM_ADJ_UNKNOWN, TASK_OTHER, TRACE_DECISION_THAW, 0);
+            frozenApps_.erase(appIter);
+        }
+        PublishStatus_();
+    }
+    frozenTasks_.erase(iter);
+}
+
+void BackgroundController::ProcStateChanged_(const int &eventDriven)
 {
-    std::unique_lock<std::mutex> lck(mtx_);
-    unblocked_ = true;
-    cv_.notify_all();
+    std::unique_lock<std::mutex> lck(eventMtx_);
+    procEventDriven_ = (eventDriven == 1);
+    procStateChanged_ = true;
 }
 
-void BackgroundController::ScreenStateChanged_(const void* data)
+void BackgroundController::TaskChanged_(const std::vector<TaskEvent> &taskEvents)
+{
+    std::unique_lock<std::mutex> lck(eventMtx_);
+    if (pendingTaskEvents_.size() + taskEvents.size() > MAX_PENDING_TASK_EVENTS) {
+        pendingTaskEvents_.clear();
+        pendingTaskEvents_.emplace_back(TaskEvent{TASK_EVENT_OVERFLOW, -1});
+    } else {
+        pendingTaskEvents_.insert(pendingTaskEvents_.end(), taskEvents.begin(), taskEvents.end());
+    }
+}
+
+void BackgroundController::CgroupModified_(const uint32_t &)
+{
+    // Keep the oldest change that no pass has picked up yet, it starts the cgroup change to thaw latency.
+    uint64_t expected = 0;
+    cgroupModifiedUs_.compare_exchange_strong(expected, GetTimeStampUs());
+    wakeup_.Notify();
+}
+
+void BackgroundController::ScreenStateChanged_(const int &screenState)
 {
-    int screenState = GetPtrData<int>(data);
     if (screenState == SCREEN_OFF) {
         if (Timer_IsTimerExist("BackgroundController.Reflash")) {
             Timer_DeleteTimer("BackgroundController.Reflash");
@@ -158,7 +692,147 @@ void BackgroundController::ScreenStateChanged_(const void* data)
 
 void BackgroundController::Reflash_()
 {
-    std::unique_lock<std::mutex> lck(mtx_);
-    unblocked_ = true;
-    cv_.notify_all();
+    wakeup_.Notify();
+}
+
+std::shared_ptr<const BackgroundController::ConfigSnapshot> BackgroundController::GetConfig_() const
+{
+    return std::atomic_load(&config_);
+}
+
+void BackgroundController::PublishConfig_(const std::shared_ptr<const ConfigSnapshot> &config)
+{
+    // Writers are serialized by configMtx_, readers never take it.
+    std::atomic_store(&config_, config);
+}
+
+void BackgroundController::PublishStatus_()
+{
+    // Called with tasksMtx_ held, readers only load the pointer.
+    auto status = std::make_shared<StatusSnapshot>();
+    status->frozenApps = frozenApps_;
+    status->killedApps = killedApps_;
+    std::atomic_store(&status_, std::shared_ptr<const StatusSnapshot>(std::move(status)));
+}
+
+void BackgroundController::RequestThaw_(const std::string &pkgName)
+{
+    {
+        std::unique_lock<std::mutex> lck(eventMtx_);
+        pendingThaws_.emplace_back(pkgName);
+    }
+    wakeup_.Notify();
+}
+
+bool BackgroundController::ListCommand_(const std::vector<std::string> &, std::string* output)
+{
+    uint64_t nowMs = GetTimeStampMs();
+    const auto &status = std::atomic_load(&status_);
+    for (const auto &[pkgName, frozenApp] : status->frozenApps) {
+        *output += StrMerge("frozen %s uid=%d tasks=%zu since=%s\n", pkgName.c_str(), frozenApp.uid, 
+            frozenApp.pids.size(), FormatTimeMs_(frozenApp.frozenAtMs, nowMs).c_str());
+    }
+    for (const auto &[pkgName, killedApp] : status->killedApps) {
+        *output += StrMerge("killed %s uid=%d times=%llu last=%s\n", pkgName.c_str(), killedApp.uid, 
+            (unsigned long long)killedApp.killNum, FormatTimeMs_(killedApp.killedAtMs, nowMs).c_str());
+    }
+
+    return true;
 }
+
+bool BackgroundController::WhitelistCommand_(const std::vector<std::string> &args, std::string* output)
+{
+    bool success = true;
+    if (args.size() == 0 || (args.size() == 1 && args[0] == "list")) {
+        for (const auto &[rule, policy] : GetConfig_()->policyRules.GetRules()) {
+            if (policy == POLICY_WHITELIST) {
+                *output += rule + "\n";
+            }
+        }
+    } else if (args.size() == 2 && (args[0] == "add" || args[0] == "remove")) {
+        // Copy on write, the controller keeps using the old snapshot until its next pass.
+        std::unique_lock<std::mutex> lck(configMtx_);
+        auto config = std::make_shared<ConfigSnapshot>(*GetConfig_());
+        // Rules with any other policy belong to the config file, this command never touches them.
+        int policy = POLICY_WHITELIST;
+        bool exist = config->policyRules.GetRule(args[1], &policy);
+        if (exist && policy != POLICY_WHITELIST) {
+            *output = StrMerge("Rule \"%s\" has policy %s, not a whitelist rule.\n", args[1].c_str(), 
+                POLICY_NAMES[policy - POLICY_WHITELIST]);
+            success = false;
+        } else if (args[0] == "add") {
+            success = config->policyRules.AddRule(args[1], POLICY_WHITELIST);
+            if (!success) {
+                *output = StrMerge("Invalid rule \"%s\".\n", args[1].c_str());
+            }
+        } else {
+            success = exist && config->policyRules.RemoveRule(args[1]);
+            if (!success) {
+                *output = StrMerge("Rule \"%s\" doesn't exist.\n", args[1].c_str());
+            }
+        }
+        if (success) {
+            const auto &prevConfig = GetConfig_();
+            PublishConfig_(config);
+            lck.unlock();
+            ApplyConfigDelta_(*prevConfig, *config);
+        }
+    } else {
+        *output = "Usage: whitelist [list | add <rule> | remove <rule>]\n";
+        success = false;
+    }
+
+    return success;
+}
+
+bool BackgroundController::PassCommand_(const std::vector<std::string> &, std::string*)
+{
+    wakeup_.Notify();
+
+    return true;
+}
+
+bool BackgroundController::ThawCommand_(const std::vector<std::string> &args, std::string* output)
+{
+    if (args.size() != 1) {
+        *output = "Usage: thaw <package>\n";
+        return false;
+    }
+
+    // The thaw itself runs on the controller thread at the start of the pass this starts.
+    if (std::atomic_load(&status_)->frozenApps.count(args[0]) == 0) {
+        *output = StrMerge("App \"%s\" is not frozen.\n", args[0].c_str());
+        return false;
+    }
+    RequestThaw_(args[0]);
+
+    return true;
+}
+
+bool BackgroundController::ThawFrozenApp_(const std::string &pkgName)
+{
+    const auto &iter = frozenApps_.find(pkgName);
+    if (iter == frozenApps_.end()) {
+        return false;
+    }
+
+    // The app starts over from its grace period if it is still frozen by policy on the next pass.
+    const auto &frozenApp = iter->second;
+    ThawApp_(frozenApp.uid, frozenApp.pids, 0);
+    UnwatchTasks_(frozenApp.pids);
+    frozenApps_.erase(iter);
+
+    return true;
+}
+
+std::string BackgroundController::FormatTimeMs_(const uint64_t &timeMs, const uint64_t &nowMs)
+{
+    // Controller timestamps are monotonic, shift them onto the wall clock for display.
+    time_t wallTime = time(nullptr) - (time_t)((nowMs - std::min(timeMs, nowMs)) / 1000);
+    struct tm tmInfo{};
+    localtime_r(&wallTime, &tmInfo);
+    char buffer[32] = { 0 };
+    strftime(buffer, sizeof(buffer), "%m-%d %H:%M:%S", &tmInfo);
+
+    return StrMerge("%s(%llus ago)", buffer, (unsigned long long)((nowMs - std::min(timeMs, nowMs)) / 1000));
+}
\ No newline at end of file
@@ -1,33 +1,153 @@
 #pragma once
 
 #include <unordered_map>
+#include <memory>
+#include <string_view>
+#include <algorithm>
+#include <iterator>
 #include <thread>
-#include <regex>
+#include <mutex>
+#include <atomic>
+#include <csignal>
 #include "platform/module.h"
 #include "utils/cu_misc.h"
+#include "utils/proc_reader.h"
+#include "utils/process_table.h"
+#include "utils/file_reader.h"
+#include "utils/pkg_name.h"
+#include "utils/pkg_matcher.h"
+#include "utils/pid_set.h"
+#include "utils/task_watcher.h"
+#include "utils/freezer.h"
+#include "utils/debouncer.h"
+#include "utils/timer_wheel.h"
+#include "utils/flight_recorder.h"
 #include "utils/CuLogger.h"
 
+// POLICY_WHITELIST (-1) ... POLICY_STRICT (2), defined in background_controller.cpp.
+#define POLICY_NUM 4
+// Apps whose oom_adj couldn't be read this pass, STATE_KILLED (0) ... STATE_FOREGROUND (2) are in the .cpp.
+#define STATE_UNKNOWN -1
+
 class BackgroundController : public Module 
 {
     public:
-        BackgroundController(const std::string &configPath);
+        BackgroundController(const std::string &configPath, const std::string &tracePath);
         ~BackgroundController();
         void Start();
 
     private:
-        std::regex pkgNameRegex_;
+        typedef struct {
+            int mainPid = -1;
+            int uid = -1;
+            int taskType = TASK_OTHER;
+            int oomAdj = TRACE_OOM_ADJ_UNKNOWN;
+            int policy = 0;
+            int state = STATE_UNKNOWN;
+            std::vector<int> pids{};
+        } AppTasks;
+
+        typedef struct {
+            int uid = -1;
+            int oomAdj = TRACE_OOM_ADJ_UNKNOWN;
+            int taskType = TASK_OTHER;
+            std::vector<int> pids{};
+            uint64_t frozenAtMs = 0;
+            int freezeRetries = 0;
+            bool confirmed = false;
+        } FrozenApp;
+
+        // Immutable once published, a reload builds a new one and swaps it in.
+        typedef struct {
+            // Package or wildcard rule to POLICY_*, apps that match no rule get defaultPolicy.
+            PkgMatcher policyRules{};
+            int defaultPolicy = 0;
+            // decisions[policy - POLICY_WHITELIST][taskType - TASK_OTHER] is the STATE_* to apply.
+            int8_t decisions[POLICY_NUM][TASK_TYPE_NUM]{};
+            uint64_t freezeGraceMs = 0;
+            uint64_t minFrozenMs = 0;
+        } ConfigSnapshot;
+
+        typedef struct {
+            int uid = -1;
+            uint64_t killedAtMs = 0;
+            uint64_t killNum = 0;
+        } KilledApp;
+
+        // What the control socket reports, republished by the controller whenever its frozen or killed apps change,
+        // so command handlers on the reactor thread never wait for a pass to release tasksMtx_.
+        typedef struct {
+            std::unordered_map<std::string, FrozenApp> frozenApps{};
+            std::unordered_map<std::string, KilledApp> killedApps{};
+        } StatusSnapshot;
+
+        typedef struct {
+            TimerWheel::TimerId timerId;
+            uint64_t passCount;
+            bool expired;
+        } GraceTimer;
+
         std::string configPath_;
-        std::vector<std::string> whiteList_;
+        std::string tracePath_;
+        std::shared_ptr<const ConfigSnapshot> config_;
+        std::mutex configMtx_;
+        ProcReader procReader_;
+        ProcessTable processTable_;
+        FileReader procsReader_;
+        std::vector<TaskEvent> pendingTaskEvents_;
+        std::vector<std::string> pendingThaws_;
+        bool procEventDriven_;
+        bool procStateChanged_;
+        std::mutex eventMtx_;
+        TaskWatcher taskWatcher_;
+        Freezer freezer_;
+        std::unordered_map<std::string, FrozenApp> frozenApps_;
+        std::unordered_map<int, std::string> frozenTasks_;
+        PidSet frozenPids_;
+        std::unordered_map<std::string, KilledApp> killedApps_;
+        std::mutex tasksMtx_;
+        std::shared_ptr<const StatusSnapshot> status_;
         CuLogger* logger_;
+        Metrics* metrics_;
+        FlightRecorder flightRecorder_;
         std::thread thread_;
-        std::condition_variable cv_;
-        std::mutex mtx_;
-        bool unblocked_;
+        Debouncer wakeup_;
+        TimerWheel freezeTimers_;
+        std::unordered_map<std::string, GraceTimer> graceTimers_;
+        uint64_t passCount_;
+        uint64_t passCgroupModifiedUs_;
+        std::atomic<uint64_t> cgroupModifiedUs_;
+        int ioFd_;
 
         void ControllerMain_();
+        uint64_t GetIoSyscallNum_();
+        void FreezeApp_(const FrozenApp &app, const std::vector<int> &pids);
+        void ThawApp_(const int &uid, const std::vector<int> &pids, const uint64_t &passId);
+        bool IsFreezeDue_(const std::string &pkgName, const uint64_t &nowMs, const ConfigSnapshot &config);
+        void UpdateFrozenApps_(std::unordered_map<std::string, FrozenApp> &needFreezeApps, 
+            const std::unordered_map<int, ProcessTable::TaskInfo> &tasks, const uint64_t &nowMs, const ConfigSnapshot &config);
+        std::shared_ptr<const ConfigSnapshot> GetConfig_() const;
+        void PublishConfig_(const std::shared_ptr<const ConfigSnapshot> &config);
+        void PublishStatus_();
+        void RequestThaw_(const std::string &pkgName);
+        void WatchTasks_(const std::string &pkgName, const std::vector<int> &pids, 
+            const std::unordered_map<int, ProcessTable::TaskInfo> &tasks);
+        void UnwatchTasks_(const std::vector<int> &pids);
         void LoadConfig_();
-        void ConfigModified_(const void* data);
-        void CgroupModified_(const void* data);
-        void ScreenStateChanged_(const void* data);
+        void ApplyConfigDelta_(const ConfigSnapshot &prevConfig, const ConfigSnapshot &config);
+        bool ThawFrozenApp_(const std::string &pkgName);
+        static void CompileDecisions_(ConfigSnapshot* config);
+        static int GetPolicy_(const std::string &policyName);
+        void ConfigModified_(const uint32_t &modifyCount);
+        void TaskExited_(int pid);
+        void ProcStateChanged_(const int &eventDriven);
+        void TaskChanged_(const std::vector<TaskEvent> &taskEvents);
+        void CgroupModified_(const uint32_t &modifyCount);
+        void ScreenStateChanged_(const int &screenState);
         void Reflash_();
+        bool ListCommand_(const std::vector<std::string> &args, std::string* output);
+        bool WhitelistCommand_(const std::vector<std::string> &args, std::string* output);
+        bool PassCommand_(const std::vector<std::string> &args, std::string* output);
+        bool ThawCommand_(const std::vector<std::string> &args, std::string* output);
+        static std::string FormatTimeMs_(const uint64_t &timeMs, const uint64_t &nowMs);
 };
@@ -1,119 +1,148 @@
 #include "cgroup_watcher.h"
 #include <sys/inotify.h>
 
-CgroupWatcher::CgroupWatcher() : Module(), thread_(), screenState_(SCREEN_OFF) { }
+constexpr size_t INOTIFY_BUFFER_SIZE = 16 * 1024;
+constexpr uint64_t CGROUP_STATS_CYCLES = 200;
+
+CgroupWatcher::CgroupWatcher() : 
+	Module(), 
+	androidSDKVersion_(0), 
+	inotifyFd_(-1), 
+	topAppWd_(-1), 
+	foregroundWd_(-1), 
+	backgroundWd_(-1), 
+	screenState_(SCREEN_OFF), 
+	screenStateProvider_(), 
+	eventNum_(0), 
+	notifyNum_(0), 
+	cycleNum_(0) { }
 
 CgroupWatcher::~CgroupWatcher() { }
 
 void CgroupWatcher::Start()
 {
-	if (GetAndroidSDKVersion() < 29) {
-		screenState_ = GetScreenStateViaWakelock();
-	} else {
-		screenState_ = GetScreenStateViaCgroup();
-	}
-	Broadcast_SendBroadcast("CgroupWatcher.ScreenStateChanged", GetDataPtr<int>(screenState_));
-
-	thread_ = std::thread(std::bind(&CgroupWatcher::Main_, this));
-	thread_.detach();
-}
-
-void CgroupWatcher::Main_()
-{
-	SetThreadName("CgroupWatcher");
 	const auto &logger = CuLogger::GetLogger();
 
-	int androidSDKVersion = GetAndroidSDKVersion();
+	androidSDKVersion_ = GetAndroidSDKVersion();
+	{
+		using namespace std::placeholders;
+		screenStateProvider_ = CreateScreenStateProvider(androidSDKVersion_, std::bind(&CgroupWatcher::ScreenStateChanged_, this, _1));
+		logger->Info("Screen state provider: %s.", screenStateProvider_->GetName());
+	}
+	screenState_ = screenStateProvider_->GetState();
+	EventBus_Publish<ScreenStateChangedTopic>(screenState_);
 
-	int fd = inotify_init();
-	if (fd < 0) {
+	inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotifyFd_ < 0) {
 		logger->Error("Failed to init inotify.");
 		std::exit(0);
 	}
+	AddWatches_();
+	{
+		using namespace std::placeholders;
+		Reactor_AddFd(inotifyFd_, EPOLLIN, std::bind(&CgroupWatcher::InotifyReadable_, this, _1));
+	}
+}
 
-	int ta_wd = -1, fg_wd = -1, bg_wd = -1, re_wd = -1;
-	if (androidSDKVersion < 29) {
-		ta_wd = inotify_add_watch(fd, "/dev/cpuset/top-app/tasks", IN_MODIFY);
-		if (ta_wd < 0) {
-			logger->Warning("Failed to watch top-app cgroup.");
-		}
-		fg_wd = inotify_add_watch(fd, "/dev/cpuset/foreground/tasks", IN_MODIFY);
-		if (fg_wd < 0) {
-			logger->Warning("Failed to watch foreground cgroup.");
-		}
-		bg_wd = inotify_add_watch(fd, "/dev/cpuset/background/tasks", IN_MODIFY);
-		if (bg_wd < 0) {
-			logger->Warning("Failed to watch background cgroup.");
-		}
-	} else if (androidSDKVersion < 33) {
-		ta_wd = inotify_add_watch(fd, "/dev/cpuset/top-app/tasks", IN_MODIFY);
-		if (ta_wd < 0) {
+void CgroupWatcher::AddWatches_()
+{
+	const auto &logger = CuLogger::GetLogger();
+
+	// The restricted cgroup is only watched by the heuristic screen state provider, when that one is in use.
+	if (androidSDKVersion_ < 33) {
+		topAppWd_ = inotify_add_watch(inotifyFd_, "/dev/cpuset/top-app/tasks", IN_MODIFY);
+		if (topAppWd_ < 0) {
 			logger->Warning("Failed to watch top-app cgroup.");
 		}
-		fg_wd = inotify_add_watch(fd, "/dev/cpuset/foreground/tasks", IN_MODIFY);
-		if (fg_wd < 0) {
+		foregroundWd_ = inotify_add_watch(inotifyFd_, "/dev/cpuset/foreground/tasks", IN_MODIFY);
+		if (foregroundWd_ < 0) {
 			logger->Warning("Failed to watch foreground cgroup.");
 		}
-		bg_wd = inotify_add_watch(fd, "/dev/cpuset/background/tasks", IN_MODIFY);
-		if (bg_wd < 0) {
+		backgroundWd_ = inotify_add_watch(inotifyFd_, "/dev/cpuset/background/tasks", IN_MODIFY);
+		if (backgroundWd_ < 0) {
 			logger->Warning("Failed to watch background cgroup.");
 		}
-		re_wd = inotify_add_watch(fd, "/dev/cpuset/restricted/tasks", IN_MODIFY);
-		if (re_wd < 0) {
-			logger->Warning("Failed to watch restricted cgroup.");
-		}
 	} else {
-		ta_wd = inotify_add_watch(fd, "/dev/cpuset/top-app/cgroup.procs", IN_MODIFY);
-		if (ta_wd < 0) {
+		topAppWd_ = inotify_add_watch(inotifyFd_, "/dev/cpuset/top-app/cgroup.procs", IN_MODIFY);
+		if (topAppWd_ < 0) {
 			logger->Warning("Failed to watch top-app cgroup.");
 		}
-		fg_wd = inotify_add_watch(fd, "/dev/cpuset/foreground/cgroup.procs", IN_MODIFY);
-		if (fg_wd < 0) {
+		foregroundWd_ = inotify_add_watch(inotifyFd_, "/dev/cpuset/foreground/cgroup.procs", IN_MODIFY);
+		if (foregroundWd_ < 0) {
 			logger->Warning("Failed to watch foreground cgroup.");
 		}
-		bg_wd = inotify_add_watch(fd, "/dev/cpuset/background/cgroup.procs", IN_MODIFY);
-		if (bg_wd < 0) {
+		backgroundWd_ = inotify_add_watch(inotifyFd_, "/dev/cpuset/background/cgroup.procs", IN_MODIFY);
+		if (backgroundWd_ < 0) {
 			logger->Warning("Failed to watch background cgroup.");
 		}
-		re_wd = inotify_add_watch(fd, "/dev/cpuset/restricted/cgroup.procs", IN_MODIFY);
-		if (re_wd < 0) {
-			logger->Warning("Failed to watch restricted cgroup.");
-		}
 	}
+}
 
-	for(;;) {
-		struct inotify_event watchEvent{};
-		read(fd, &watchEvent, sizeof(struct inotify_event));
-		if (watchEvent.mask == IN_MODIFY) {
-			if (screenState_ == SCREEN_ON) {
-				if (watchEvent.wd == ta_wd) {
-					Broadcast_SendBroadcast("CgroupWatcher.TopAppCgroupModified", nullptr);
-				} else if (watchEvent.wd == fg_wd) {
-					Broadcast_SendBroadcast("CgroupWatcher.ForegroundCgroupModified", nullptr);
-				} else if (watchEvent.wd == bg_wd) {
-					Broadcast_SendBroadcast("CgroupWatcher.BackgroundCgroupModified", nullptr);
-				}
-
-				if (androidSDKVersion < 29) {
-					screenState_ = GetScreenStateViaWakelock();
-				} else {
-					screenState_ = GetScreenStateViaCgroup();
-				}
-				if (screenState_ == SCREEN_OFF) {
-					Broadcast_SendBroadcast("CgroupWatcher.ScreenStateChanged", GetDataPtr<int>(screenState_));
-				}
-			} else {
-				if (androidSDKVersion < 29) {
-					screenState_ = GetScreenStateViaWakelock();
-				} else {
-					screenState_ = GetScreenStateViaCgroup();
-				}
-				if (screenState_ == SCREEN_ON) {
-					Broadcast_SendBroadcast("CgroupWatcher.ScreenStateChanged", GetDataPtr<int>(screenState_));
+void CgroupWatcher::InotifyReadable_(uint32_t)
+{
+	// Drain everything that is queued and count the events per watch, thread migrations on
+	// the tasks files easily produce hundreds of events for a single app launch.
+	uint32_t topAppNum = 0, foregroundNum = 0, backgroundNum = 0;
+	for (;;) {
+		char buffer[INOTIFY_BUFFER_SIZE] __attribute__((aligned(__alignof__(struct inotify_event))));
+		ssize_t len = read(inotifyFd_, buffer, sizeof(buffer));
+		if (len <= 0) {
+			break;
+		}
+		for (ssize_t offset = 0; offset < len;) {
+			auto watchEvent = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+			if (watchEvent->mask == IN_MODIFY) {
+				if (watchEvent->wd == topAppWd_) {
+					topAppNum++;
+				} else if (watchEvent->wd == foregroundWd_) {
+					foregroundNum++;
+				} else if (watchEvent->wd == backgroundWd_) {
+					backgroundNum++;
 				}
 			}
+			offset += sizeof(struct inotify_event) + watchEvent->len;
 		}
 	}
-	
-	close(fd);
+	if (topAppNum + foregroundNum + backgroundNum > 0) {
+		CgroupsModified_(topAppNum, foregroundNum, backgroundNum);
+	}
+}
+
+void CgroupWatcher::CgroupsModified_(const uint32_t &topAppNum, const uint32_t &foregroundNum, const uint32_t &backgroundNum)
+{
+	const auto &metrics = Metrics::GetInstance();
+	uint32_t eventNum = topAppNum + foregroundNum + backgroundNum;
+	metrics->AddCounter(METRIC_CGROUP_EVENTS, eventNum);
+	eventNum_ += eventNum;
+	cycleNum_++;
+	if (cycleNum_ % CGROUP_STATS_CYCLES == 0) {
+		CU_LOGD("Cgroup events: %llu events merged into %llu notifications over %llu cycles.", 
+			(unsigned long long)eventNum_, (unsigned long long)notifyNum_, (unsigned long long)cycleNum_);
+	}
+
+	// At most one notification per cgroup per drain cycle, the payload carries how many events were merged into it.
+	if (screenState_ == SCREEN_ON) {
+		if (topAppNum > 0) {
+			EventBus_Publish<TopAppCgroupModifiedTopic>(topAppNum);
+			metrics->AddCounter(METRIC_CGROUP_NOTIFICATIONS);
+			notifyNum_++;
+		}
+		if (foregroundNum > 0) {
+			EventBus_Publish<ForegroundCgroupModifiedTopic>(foregroundNum);
+			metrics->AddCounter(METRIC_CGROUP_NOTIFICATIONS);
+			notifyNum_++;
+		}
+		if (backgroundNum > 0) {
+			EventBus_Publish<BackgroundCgroupModifiedTopic>(backgroundNum);
+			metrics->AddCounter(METRIC_CGROUP_NOTIFICATIONS);
+			notifyNum_++;
+		}
+	}
+}
+
+void CgroupWatcher::ScreenStateChanged_(int screenState)
+{
+	// Called by the provider on real transitions only, on the reactor thread like the cgroup events.
+	screenState_ = screenState;
+	EventBus_Publish<ScreenStateChangedTopic>(screenState_);
 }
@@ -1,8 +1,9 @@
 #pragma once
 
-#include <thread>
+#include <memory>
 #include "platform/module.h"
 #include "utils/cu_misc.h"
+#include "utils/screen_state_provider.h"
 #include "utils/CuLogger.h"
 
 class CgroupWatcher : public Module
@@ -13,8 +14,19 @@ class CgroupWatcher : public Module
 		void Start();
 
 	private:
-		std::thread thread_;
+		int androidSDKVersion_;
+		int inotifyFd_;
+		int topAppWd_;
+		int foregroundWd_;
+		int backgroundWd_;
 		int screenState_;
+		std::unique_ptr<ScreenStateProvider> screenStateProvider_;
+		uint64_t eventNum_;
+		uint64_t notifyNum_;
+		uint64_t cycleNum_;
 
-		void Main_();
+		void AddWatches_();
+		void InotifyReadable_(uint32_t events);
+		void CgroupsModified_(const uint32_t &topAppNum, const uint32_t &foregroundNum, const uint32_t &backgroundNum);
+		void ScreenStateChanged_(int screenState);
 };
\ No newline at end of file
@@ -1,37 +1,98 @@
 #include "config_watcher.h"
 #include <sys/inotify.h>
+#include <sys/timerfd.h>
 
-ConfigWatcher::ConfigWatcher(const std::string &configPath) : Module(), configPath_(configPath), thread_() { }
+constexpr uint64_t CONFIG_TRAILING_MS = 200;
+constexpr uint64_t CONFIG_MAX_LATENCY_MS = 1000;
+
+ConfigWatcher::ConfigWatcher(const std::string &configPath) : 
+    Module(), 
+    configPath_(configPath), 
+    configDir_(), 
+    configName_(), 
+    inotifyFd_(-1), 
+    timerFd_(-1), 
+    firstEventMs_(0) { }
 
 ConfigWatcher::~ConfigWatcher() { }
 
 void ConfigWatcher::Start()
 {
-    thread_ = std::thread(std::bind(&ConfigWatcher::Main_, this));
-    thread_.detach();
-}
-
-void ConfigWatcher::Main_()
-{
-    SetThreadName("ConfigWatcher");
     const auto &logger = CuLogger::GetLogger();
 
-    int fd = inotify_init();
-	if (fd < 0) {
-		logger->Error("Failed to init inotify.");
-		std::exit(0);
-	}
-    if (inotify_add_watch(fd, configPath_.c_str(), IN_MODIFY) < 0) {
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0) {
+        logger->Error("Failed to init inotify.");
+        std::exit(0);
+    }
+    // Editors and adb push replace the file by a rename, a watch on the file itself would be left on the old inode.
+    // The directory watch sees both in-place writes and replacements, events for other files are filtered out by name.
+    configDir_ = StrContains(configPath_, "/") ? GetRePrevString(configPath_, '/') : ".";
+    configName_ = GetRePostString(configPath_, '/');
+    if (configDir_.empty()) {
+        configDir_ = "/";
+    }
+    if (inotify_add_watch(inotifyFd_, configDir_.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
         logger->Error("Failed to add watch.");
-		std::exit(0);
+        std::exit(0);
+    }
+    timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd_ < 0) {
+        logger->Error("Failed to create timerfd.");
+        std::exit(0);
     }
+    {
+        using namespace std::placeholders;
+        Reactor_AddFd(inotifyFd_, EPOLLIN, std::bind(&ConfigWatcher::InotifyReadable_, this, _1));
+        Reactor_AddFd(timerFd_, EPOLLIN, std::bind(&ConfigWatcher::TimerExpired_, this, _1));
+    }
+}
 
+void ConfigWatcher::InotifyReadable_(uint32_t)
+{
+    bool modified = false;
     for (;;) {
-        struct inotify_event watchEvent{};
-		read(fd, &watchEvent, sizeof(struct inotify_event));
-		if (watchEvent.mask == IN_MODIFY) {
-            Broadcast_SendBroadcast("ConfigWatcher.ConfigModified", nullptr);
+        char buffer[1024] __attribute__((aligned(__alignof__(struct inotify_event))));
+        ssize_t len = read(inotifyFd_, buffer, sizeof(buffer));
+        if (len <= 0) {
+            break;
+        }
+        for (ssize_t offset = 0; offset < len;) {
+            auto watchEvent = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            if ((watchEvent->mask & (IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO)) != 0 && watchEvent->len > 0 && 
+                strcmp(watchEvent->name, configName_.c_str()) == 0) {
+                Metrics::GetInstance()->AddCounter(METRIC_CONFIG_EVENTS);
+                modified = true;
+            }
+            offset += sizeof(struct inotify_event) + watchEvent->len;
         }
-        usleep(500000);
+    }
+    if (!modified) {
+        return;
+    }
+
+    // A single save usually shows up as several writes followed by a close or a rename, merge them into one reload:
+    // each event pushes the reload back by CONFIG_TRAILING_MS, up to CONFIG_MAX_LATENCY_MS after the first one,
+    // so a reload never reads a file that is still half written unless the writer stalls for that long.
+    uint64_t nowMs = GetTimeStampMs();
+    if (firstEventMs_ == 0) {
+        firstEventMs_ = nowMs;
+    }
+    uint64_t deadlineMs = std::min(nowMs + CONFIG_TRAILING_MS, firstEventMs_ + CONFIG_MAX_LATENCY_MS);
+    uint64_t delayMs = deadlineMs > nowMs ? deadlineMs - nowMs : 0;
+    struct itimerspec its{};
+    its.it_value.tv_sec = delayMs / 1000;
+    // it_value must not be zero, that would disarm the timer.
+    its.it_value.tv_nsec = (delayMs % 1000) * 1000000 + 1;
+    timerfd_settime(timerFd_, 0, &its, nullptr);
+}
+
+void ConfigWatcher::TimerExpired_(uint32_t)
+{
+    uint64_t expirations = 0;
+    if (read(timerFd_, &expirations, sizeof(expirations)) > 0) {
+        firstEventMs_ = 0;
+        Metrics::GetInstance()->AddCounter(METRIC_CONFIG_RELOADS);
+        EventBus_Publish<ConfigModifiedTopic>(1);
     }
 }
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <thread>
 #include "platform/module.h"
 #include "utils/cu_misc.h"
 #include "utils/CuLogger.h"
@@ -14,7 +13,12 @@ class ConfigWatcher : public Module
 
     private:
         std::string configPath_;
-        std::thread thread_;
+        std::string configDir_;
+        std::string configName_;
+        int inotifyFd_;
+        int timerFd_;
+        uint64_t firstEventMs_;
 
-        void Main_();
+        void InotifyReadable_(uint32_t events);
+        void TimerExpired_(uint32_t events);
 };
\ No newline at end of file
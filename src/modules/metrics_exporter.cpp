@@ -0,0 +1,76 @@
+#include "metrics_exporter.h"
+
+constexpr int DEFAULT_METRICS_INTERVAL_MS = 10000;
+constexpr int64_t MAX_METRICS_INTERVAL_MS = 3600 * 1000;
+
+MetricsExporter::MetricsExporter(const std::string &configPath, const std::string &metricsPath) : 
+    Module(), 
+    configPath_(configPath), 
+    metricsPath_(metricsPath), 
+    intervalMs_(-1) { }
+
+MetricsExporter::~MetricsExporter() { }
+
+void MetricsExporter::Start()
+{
+    LoadConfig_();
+    {
+        using namespace std::placeholders;
+        EventBus_Subscribe<ConfigModifiedTopic>(std::bind(&MetricsExporter::ConfigModified_, this, _1));
+        Control_RegisterCommand("metrics", std::bind(&MetricsExporter::MetricsCommand_, this, _1, _2));
+    }
+}
+
+void MetricsExporter::LoadConfig_()
+{
+    int intervalMs = DEFAULT_METRICS_INTERVAL_MS;
+    const auto &lines = StrSplit(ReadFileEx(configPath_), "\n");
+    const auto &logger = CuLogger::GetLogger();
+    for (const auto &line : lines) {
+        // Same comment handling as the controller, which owns every other option of the file.
+        const auto &content = StripConfigComment(line);
+        if (!StrContains(content, "=") || TrimStr(GetPrevString(content, '=')) != "metrics_interval_ms") {
+            continue;
+        }
+        const auto &value = GetPostString(content, '=');
+        int64_t integer = 0;
+        if (StringToInt64(value, &integer) && integer >= 0 && integer <= MAX_METRICS_INTERVAL_MS) {
+            intervalMs = (int)integer;
+        } else {
+            logger->Warning("Invalid value \"%s\" for \"metrics_interval_ms\", ignored.", TrimStr(value).c_str());
+        }
+    }
+    if (intervalMs == intervalMs_) {
+        return;
+    }
+
+    intervalMs_ = intervalMs;
+    if (Timer_IsTimerExist("MetricsExporter.Export")) {
+        Timer_DeleteTimer("MetricsExporter.Export");
+    }
+    if (intervalMs_ > 0) {
+        Timer_AddTimer("MetricsExporter.Export", std::bind(&MetricsExporter::Export_, this), intervalMs_, TIMER_FIXED_DELAY);
+        logger->Info("Metrics are exported to \"%s\" every %dms.", metricsPath_.c_str(), intervalMs_);
+    } else {
+        logger->Info("Metrics export is disabled.");
+    }
+}
+
+void MetricsExporter::ConfigModified_(const uint32_t &)
+{
+    LoadConfig_();
+}
+
+void MetricsExporter::Export_()
+{
+    const auto &tmpPath = metricsPath_ + ".tmp";
+    CreateFile(tmpPath, Metrics::GetInstance()->Export());
+    rename(tmpPath.c_str(), metricsPath_.c_str());
+}
+
+bool MetricsExporter::MetricsCommand_(const std::vector<std::string> &, std::string* output)
+{
+    *output = Metrics::GetInstance()->Export();
+
+    return true;
+}
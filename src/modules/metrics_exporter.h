@@ -0,0 +1,26 @@
+#pragma once
+
+#include "platform/module.h"
+#include "platform/metrics.h"
+#include "utils/cu_misc.h"
+#include "utils/CuLogger.h"
+
+// Writes a Prometheus text snapshot of Metrics to metricsPath every metrics_interval_ms (config option, 0 disables it).
+// The snapshot is written to a temporary file and renamed over the old one, so scrapers never see a partial file.
+class MetricsExporter : public Module
+{
+    public:
+        MetricsExporter(const std::string &configPath, const std::string &metricsPath);
+        ~MetricsExporter();
+        void Start();
+
+    private:
+        std::string configPath_;
+        std::string metricsPath_;
+        int intervalMs_;
+
+        void LoadConfig_();
+        void ConfigModified_(const uint32_t &modifyCount);
+        void Export_();
+        bool MetricsCommand_(const std::vector<std::string> &args, std::string* output);
+};
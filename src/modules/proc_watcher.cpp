@@ -0,0 +1,140 @@
+#include "proc_watcher.h"
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+ProcWatcher::ProcWatcher() : Module(), sockFd_(-1), events_() { }
+
+ProcWatcher::~ProcWatcher() { }
+
+void ProcWatcher::Start()
+{
+	const auto &logger = CuLogger::GetLogger();
+
+	int eventDriven = 0;
+	if (Connect_()) {
+		logger->Info("Process events are delivered by proc connector.");
+		eventDriven = 1;
+		EventBus_Publish<ProcStateChangedTopic>(eventDriven);
+
+		using namespace std::placeholders;
+		Reactor_AddFd(sockFd_, EPOLLIN, std::bind(&ProcWatcher::SocketReadable_, this, _1));
+	} else {
+		logger->Warning("Proc connector is unavailable, fall back to rescanning.");
+		EventBus_Publish<ProcStateChangedTopic>(eventDriven);
+	}
+}
+
+bool ProcWatcher::Connect_()
+{
+	sockFd_ = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+	if (sockFd_ < 0) {
+		return false;
+	}
+
+	struct sockaddr_nl addr{};
+	addr.nl_family = AF_NETLINK;
+	addr.nl_groups = CN_IDX_PROC;
+	addr.nl_pid = 0;
+	if (bind(sockFd_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+		close(sockFd_);
+		sockFd_ = -1;
+		return false;
+	}
+
+	char buffer[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))] = { 0 };
+	auto nlHdr = reinterpret_cast<struct nlmsghdr*>(buffer);
+	nlHdr->nlmsg_len = sizeof(buffer);
+	nlHdr->nlmsg_type = NLMSG_DONE;
+	nlHdr->nlmsg_pid = getpid();
+	auto cnMsg = reinterpret_cast<struct cn_msg*>(NLMSG_DATA(nlHdr));
+	cnMsg->id.idx = CN_IDX_PROC;
+	cnMsg->id.val = CN_VAL_PROC;
+	cnMsg->len = sizeof(enum proc_cn_mcast_op);
+	*reinterpret_cast<enum proc_cn_mcast_op*>(cnMsg->data) = PROC_CN_MCAST_LISTEN;
+	if (send(sockFd_, buffer, sizeof(buffer), 0) < 0) {
+		close(sockFd_);
+		sockFd_ = -1;
+		return false;
+	}
+
+	return true;
+}
+
+void ProcWatcher::SocketReadable_(uint32_t)
+{
+	const auto &logger = CuLogger::GetLogger();
+
+	// Drain everything queued on the socket, so a burst of events costs one wakeup.
+	for (;;) {
+		char buffer[8192] __attribute__((aligned(NLMSG_ALIGNTO)));
+		ssize_t len = recv(sockFd_, buffer, sizeof(buffer), 0);
+		if (len < 0) {
+			if (errno == ENOBUFS) {
+				// The socket overran and events were lost.
+				events_.clear();
+				events_.emplace_back(TaskEvent{TASK_EVENT_OVERFLOW, -1});
+				EventBus_Publish<TaskChangedTopic>(events_);
+				continue;
+			} else if (errno == EINTR) {
+				continue;
+			} else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				logger->Error("Proc connector is broken, fall back to rescanning.");
+				int eventDriven = 0;
+				EventBus_Publish<ProcStateChangedTopic>(eventDriven);
+				Disconnect_();
+			}
+			break;
+		}
+
+		events_.clear();
+		auto nlHdr = reinterpret_cast<struct nlmsghdr*>(buffer);
+		for (; NLMSG_OK(nlHdr, len); nlHdr = NLMSG_NEXT(nlHdr, len)) {
+			if (nlHdr->nlmsg_type == NLMSG_ERROR || nlHdr->nlmsg_type == NLMSG_NOOP) {
+				continue;
+			}
+			auto cnMsg = reinterpret_cast<const struct cn_msg*>(NLMSG_DATA(nlHdr));
+			if (cnMsg->id.idx != CN_IDX_PROC || cnMsg->id.val != CN_VAL_PROC) {
+				continue;
+			}
+			// Only process-level events matter, thread events are dropped here.
+			auto procEvent = reinterpret_cast<const struct proc_event*>(cnMsg->data);
+			switch (procEvent->what) {
+				case proc_event::PROC_EVENT_FORK:
+					if (procEvent->event_data.fork.child_pid == procEvent->event_data.fork.child_tgid) {
+						events_.emplace_back(TaskEvent{TASK_EVENT_FORK, procEvent->event_data.fork.child_tgid});
+					}
+					break;
+				case proc_event::PROC_EVENT_EXEC:
+					events_.emplace_back(TaskEvent{TASK_EVENT_EXEC, procEvent->event_data.exec.process_tgid});
+					break;
+				case proc_event::PROC_EVENT_COMM:
+					if (procEvent->event_data.comm.process_pid == procEvent->event_data.comm.process_tgid) {
+						events_.emplace_back(TaskEvent{TASK_EVENT_COMM, procEvent->event_data.comm.process_tgid});
+					}
+					break;
+				case proc_event::PROC_EVENT_UID:
+					events_.emplace_back(TaskEvent{TASK_EVENT_UID, procEvent->event_data.id.process_tgid});
+					break;
+				case proc_event::PROC_EVENT_EXIT:
+					if (procEvent->event_data.exit.process_pid == procEvent->event_data.exit.process_tgid) {
+						events_.emplace_back(TaskEvent{TASK_EVENT_EXIT, procEvent->event_data.exit.process_tgid});
+					}
+					break;
+				default:
+					break;
+			}
+		}
+		if (!events_.empty()) {
+			EventBus_Publish<TaskChangedTopic>(events_);
+		}
+	}
+}
+
+void ProcWatcher::Disconnect_()
+{
+	Reactor_RemoveFd(sockFd_);
+	close(sockFd_);
+	sockFd_ = -1;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+#include "platform/module.h"
+#include "utils/cu_misc.h"
+#include "utils/process_table.h"
+#include "utils/CuLogger.h"
+
+class ProcWatcher : public Module
+{
+	public:
+		ProcWatcher();
+		~ProcWatcher();
+		void Start();
+
+	private:
+		int sockFd_;
+		std::vector<TaskEvent> events_;
+
+		bool Connect_();
+		void SocketReadable_(uint32_t events);
+		void Disconnect_();
+};
@@ -0,0 +1,160 @@
+#include "control_server.h"
+
+constexpr uid_t AID_ROOT = 0;
+constexpr uid_t AID_SHELL = 2000;
+constexpr int CONTROL_TIMEOUT_SEC = 2;
+constexpr int CONTROL_BIND_RETRIES = 20;
+
+ControlServer::ControlServer() : listenFd_(-1), handlerMap_(), mtx_() { }
+
+ControlServer::~ControlServer()
+{
+    if (listenFd_ >= 0) {
+        Reactor::GetInstance()->RemoveFd(listenFd_);
+        close(listenFd_);
+    }
+}
+
+void ControlServer::RegisterCommand(const std::string &command, const CommandHandler &handler)
+{
+    std::unique_lock<std::mutex> lck(mtx_);
+    handlerMap_[command] = handler;
+}
+
+bool ControlServer::Listen(const std::string &socketName)
+{
+    listenFd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0) {
+        return false;
+    }
+
+    struct sockaddr_un addr{};
+    socklen_t addrLen = GetSocketAddr_(socketName, &addr);
+    int ret = bind(listenFd_, (struct sockaddr*)&addr, addrLen);
+    // The daemon being replaced may still hold the name for a moment after SIGINT. Sleeping here blocks for up
+    // to 2s, which is only fine because Listen() runs during startup, before the reactor loop serves any fd.
+    for (int retry = 0; ret < 0 && errno == EADDRINUSE && retry < CONTROL_BIND_RETRIES; retry++) {
+        usleep(100000);
+        ret = bind(listenFd_, (struct sockaddr*)&addr, addrLen);
+    }
+    if (ret < 0 || listen(listenFd_, 8) < 0) {
+        close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+    {
+        using namespace std::placeholders;
+        Reactor::GetInstance()->AddFd(listenFd_, EPOLLIN, std::bind(&ControlServer::ListenReadable_, this, _1));
+    }
+
+    return true;
+}
+
+bool ControlServer::SendRequest(const std::string &socketName, const std::string &request, std::string* response)
+{
+    int sockFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (sockFd < 0) {
+        return false;
+    }
+
+    bool success = false;
+    {
+        struct timeval tv{};
+        tv.tv_sec = CONTROL_TIMEOUT_SEC;
+        setsockopt(sockFd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(sockFd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    }
+    struct sockaddr_un addr{};
+    socklen_t addrLen = GetSocketAddr_(socketName, &addr);
+    if (connect(sockFd, (struct sockaddr*)&addr, addrLen) == 0 &&
+        send(sockFd, request.data(), request.size(), MSG_NOSIGNAL) == (ssize_t)request.size()) {
+        std::string buffer(CONTROL_MAX_MESSAGE_SIZE, '\0');
+        ssize_t len = recv(sockFd, &buffer[0], buffer.size(), 0);
+        if (len > 0) {
+            buffer.resize(len);
+            *response = std::move(buffer);
+            success = true;
+        }
+    }
+    close(sockFd);
+
+    return success;
+}
+
+void ControlServer::ListenReadable_(uint32_t)
+{
+    for (;;) {
+        int clientFd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (clientFd < 0) {
+            break;
+        }
+        struct ucred cred{};
+        socklen_t credLen = sizeof(cred);
+        if (getsockopt(clientFd, SOL_SOCKET, SO_PEERCRED, &cred, &credLen) < 0 ||
+            (cred.uid != AID_ROOT && cred.uid != AID_SHELL)) {
+            close(clientFd);
+            continue;
+        }
+        using namespace std::placeholders;
+        if (!Reactor::GetInstance()->AddFd(clientFd, EPOLLIN, std::bind(&ControlServer::ClientReadable_, this, clientFd, _1))) {
+            close(clientFd);
+        }
+    }
+}
+
+void ControlServer::ClientReadable_(int clientFd, uint32_t)
+{
+    char buffer[1024] = { 0 };
+    ssize_t len = recv(clientFd, buffer, sizeof(buffer) - 1, 0);
+    if (len < 0 && (errno == EAGAIN || errno == EINTR)) {
+        return;
+    }
+    if (len > 0) {
+        auto response = HandleRequest_(std::string(buffer, len));
+        if (response.size() > CONTROL_MAX_MESSAGE_SIZE) {
+            response.resize(CONTROL_MAX_MESSAGE_SIZE);
+        }
+        send(clientFd, response.data(), response.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+    }
+    Reactor::GetInstance()->RemoveFd(clientFd);
+    close(clientFd);
+}
+
+std::string ControlServer::HandleRequest_(const std::string &request)
+{
+    std::vector<std::string> args{};
+    for (const auto &arg : StrSplit(request, " ")) {
+        if (!arg.empty()) {
+            args.emplace_back(arg);
+        }
+    }
+    if (args.empty()) {
+        return "ERR\nEmpty request.\n";
+    }
+
+    CommandHandler handler = nullptr;
+    {
+        std::unique_lock<std::mutex> lck(mtx_);
+        const auto &iter = handlerMap_.find(args[0]);
+        if (iter != handlerMap_.end()) {
+            handler = iter->second;
+        }
+    }
+    if (!handler) {
+        return StrMerge("ERR\nUnknown command \"%s\".\n", args[0].c_str());
+    }
+    std::string output{};
+    bool success = handler(std::vector<std::string>(args.begin() + 1, args.end()), &output);
+
+    return (success ? "OK\n" : "ERR\n") + output;
+}
+
+socklen_t ControlServer::GetSocketAddr_(const std::string &socketName, struct sockaddr_un* addr)
+{
+    // Abstract namespace: sun_path starts with a NUL byte and the name is not NUL-terminated.
+    addr->sun_family = AF_UNIX;
+    size_t nameLen = std::min(socketName.size(), sizeof(addr->sun_path) - 1);
+    memcpy(addr->sun_path + 1, socketName.data(), nameLen);
+
+    return (socklen_t)(offsetof(struct sockaddr_un, sun_path) + 1 + nameLen);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "singleton.h"
+#include "reactor.h"
+#include "utils/cu_misc.h"
+
+// Abstract UNIX socket name, "@CuBackgroundCtrl" in /proc/net/unix.
+#define CONTROL_SOCKET_NAME "CuBackgroundCtrl"
+#define CONTROL_MAX_MESSAGE_SIZE 65536
+
+// Local control plane on a SOCK_SEQPACKET socket, one request and one response per connection.
+// A request is a single message "<command> [args...]" separated by spaces, the response is a single message
+// whose first line is "OK" or "ERR" followed by the command output. Only root and shell may connect.
+// Handlers are registered by the modules and run on the reactor thread, they must not block.
+class ControlServer : public Singleton<ControlServer>
+{
+    public:
+        using CommandHandler = std::function<bool(const std::vector<std::string> &args, std::string* output)>;
+
+        ControlServer();
+        ~ControlServer();
+        void RegisterCommand(const std::string &command, const CommandHandler &handler);
+        bool Listen(const std::string &socketName);
+        static bool SendRequest(const std::string &socketName, const std::string &request, std::string* response);
+
+    private:
+        int listenFd_;
+        std::unordered_map<std::string, CommandHandler> handlerMap_;
+        std::mutex mtx_;
+
+        void ListenReadable_(uint32_t events);
+        void ClientReadable_(int clientFd, uint32_t events);
+        std::string HandleRequest_(const std::string &request);
+        static socklen_t GetSocketAddr_(const std::string &socketName, struct sockaddr_un* addr);
+};
@@ -0,0 +1,123 @@
+#include "event_bus.h"
+
+EventBus::EventBus() : 
+    head_(&stub_), 
+    tail_(&stub_), 
+    stub_(-1, COALESCE_NONE), 
+    pending_(false), 
+    eventFd_(-1), 
+    receivers_(), 
+    receiverMtx_(), 
+    thread_()
+{
+    eventFd_ = eventfd(0, EFD_CLOEXEC);
+    thread_ = std::thread(std::bind(&EventBus::DispatcherMain_, this));
+    thread_.detach();
+}
+
+EventBus::~EventBus() 
+{
+    if (eventFd_ >= 0) {
+        close(eventFd_);
+    }
+}
+
+void EventBus::Push_(Message* message)
+{
+    // Vyukov's intrusive MPSC queue: one exchange per publish, no locks.
+    message->next.store(nullptr, std::memory_order_relaxed);
+    Message* prev = head_.exchange(message, std::memory_order_acq_rel);
+    prev->next.store(message, std::memory_order_release);
+
+    // Only the publisher that finds the dispatcher idle pays for the wakeup.
+    if (!pending_.exchange(true, std::memory_order_acq_rel)) {
+        uint64_t value = 1;
+        write(eventFd_, &value, sizeof(value));
+    }
+}
+
+EventBus::Message* EventBus::Pop_()
+{
+    Message* tail = tail_;
+    Message* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+        if (next == nullptr) {
+            return nullptr;
+        }
+        tail_ = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+        tail_ = next;
+        return tail;
+    }
+    if (tail != head_.load(std::memory_order_acquire)) {
+        // A publisher is between its exchange and its link, it will signal the eventfd afterwards.
+        return nullptr;
+    }
+    stub_.next.store(nullptr, std::memory_order_relaxed);
+    Message* prev = head_.exchange(&stub_, std::memory_order_acq_rel);
+    prev->next.store(&stub_, std::memory_order_release);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+        tail_ = next;
+        return tail;
+    }
+
+    return nullptr;
+}
+
+void EventBus::DispatcherMain_()
+{
+    SetThreadName("EventBus");
+
+    std::vector<Message*> batch{};
+    for (;;) {
+        uint64_t value = 0;
+        if (read(eventFd_, &value, sizeof(value)) < 0 && errno != EINTR) {
+            break;
+        }
+        pending_.store(false, std::memory_order_release);
+        for (;;) {
+            Message* message = Pop_();
+            if (message == nullptr) {
+                break;
+            }
+            batch.emplace_back(message);
+        }
+        if (!batch.empty()) {
+            Dispatch_(batch);
+            for (Message* message : batch) {
+                delete message;
+            }
+            batch.clear();
+        }
+    }
+}
+
+void EventBus::Dispatch_(std::vector<Message*> &batch)
+{
+    // Coalesced topics are delivered once, at the position of their newest message.
+    size_t lastIdx[TOPIC_NUM] = { 0 };
+    for (size_t idx = 0; idx < batch.size(); idx++) {
+        lastIdx[batch[idx]->topicId] = idx;
+    }
+    for (size_t idx = 0; idx < batch.size(); idx++) {
+        const Message* message = batch[idx];
+        if (message->policy == COALESCE_COUNTER && idx != lastIdx[message->topicId]) {
+            batch[lastIdx[message->topicId]]->Merge(message);
+        }
+    }
+
+    std::unique_lock<std::mutex> lck(receiverMtx_);
+    for (size_t idx = 0; idx < batch.size(); idx++) {
+        const Message* message = batch[idx];
+        if (message->policy != COALESCE_NONE && idx != lastIdx[message->topicId]) {
+            continue;
+        }
+        for (const auto &receiver : receivers_[message->topicId]) {
+            receiver(message);
+        }
+    }
+}
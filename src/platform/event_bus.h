@@ -0,0 +1,88 @@
+#pragma once
+
+#include <iostream>
+#include <functional>
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cerrno>
+#include <sys/eventfd.h>
+#include "singleton.h"
+#include "topics.h"
+#include "utils/cu_misc.h"
+
+// Typed publish/subscribe bus. Publish() copies (or moves) the payload into a node, pushes it onto a
+// lock-free MPSC queue and returns, it never waits for subscribers. A dispatcher thread drains the queue
+// in batches, applies each topic's coalescing policy to the batch and calls the subscribers in order.
+// Receivers run on the dispatcher thread and must not subscribe from inside a callback.
+class EventBus : public Singleton<EventBus>
+{
+    public:
+        EventBus();
+        ~EventBus();
+
+        template <typename TopicType>
+        void Subscribe(const std::function<void(const typename TopicType::Payload &)> &receiver)
+        {
+            static_assert(TopicType::ID >= 0 && TopicType::ID < TOPIC_NUM, "Topic ID out of range.");
+            std::unique_lock<std::mutex> lck(receiverMtx_);
+            receivers_[TopicType::ID].emplace_back([receiver](const Message* message) {
+                receiver(static_cast<const TypedMessage<typename TopicType::Payload>*>(message)->payload);
+            });
+        }
+
+        template <typename TopicType>
+        void Publish(typename TopicType::Payload payload)
+        {
+            static_assert(TopicType::ID >= 0 && TopicType::ID < TOPIC_NUM, "Topic ID out of range.");
+            auto message = new TypedMessage<typename TopicType::Payload>(TopicType::ID, TopicType::POLICY, std::move(payload));
+            Push_(message);
+        }
+
+    private:
+        struct Message
+        {
+            std::atomic<Message*> next;
+            int topicId;
+            int policy;
+
+            Message(const int &id, const int &coalescePolicy) : next(nullptr), topicId(id), policy(coalescePolicy) { }
+            virtual ~Message() { }
+            virtual void Merge(const Message* /*other*/) { }
+        };
+
+        template <typename T>
+        struct TypedMessage : public Message
+        {
+            T payload;
+
+            TypedMessage(const int &id, const int &coalescePolicy, T &&data) : 
+                Message(id, coalescePolicy), payload(std::move(data)) { }
+
+            void Merge(const Message* other) override
+            {
+                if constexpr (std::is_arithmetic<T>::value) {
+                    payload += static_cast<const TypedMessage<T>*>(other)->payload;
+                }
+            }
+        };
+
+        using Receiver = std::function<void(const Message*)>;
+
+        std::atomic<Message*> head_;
+        Message* tail_;
+        Message stub_;
+        std::atomic<bool> pending_;
+        int eventFd_;
+        std::vector<Receiver> receivers_[TOPIC_NUM];
+        std::mutex receiverMtx_;
+        std::thread thread_;
+
+        void Push_(Message* message);
+        Message* Pop_();
+        void DispatcherMain_();
+        void Dispatch_(std::vector<Message*> &batch);
+};
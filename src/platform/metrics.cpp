@@ -0,0 +1,94 @@
+#include "metrics.h"
+
+typedef struct {
+    const char* name;
+    const char* help;
+} CounterInfo;
+
+typedef struct {
+    const char* name;
+    const char* help;
+    // Multiplier from the recorded unit to the exported one, durations are recorded in us and exported in seconds.
+    double scale;
+} HistogramInfo;
+
+constexpr CounterInfo COUNTER_INFOS[METRIC_COUNTER_NUM] = {
+    {"cubgctrl_controller_passes_total", "Controller passes."},
+    {"cubgctrl_controller_pids_scanned_total", "Tasks read from the background cgroup."},
+    {"cubgctrl_controller_kills_total", "Tasks sent SIGKILL."},
+    {"cubgctrl_controller_freezes_total", "Apps frozen."},
+    {"cubgctrl_controller_thaws_total", "Apps thawed."},
+    {"cubgctrl_cgroup_inotify_events_total", "Inotify events read from the cgroup watches."},
+    {"cubgctrl_cgroup_notifications_total", "Cgroup notifications published after merging."},
+    {"cubgctrl_config_inotify_events_total", "Inotify events read from the config watch."},
+    {"cubgctrl_config_reloads_total", "Config reloads published after debouncing."},
+    {"cubgctrl_timer_runs_total", "Timer tasks run."},
+};
+
+constexpr HistogramInfo HISTOGRAM_INFOS[METRIC_HISTOGRAM_NUM] = {
+    {"cubgctrl_controller_pass_duration_seconds", "Time spent in one controller pass.", 1e-6},
+    {"cubgctrl_controller_pass_io_syscalls", "Read and write family syscalls made by one controller pass.", 1.0},
+    {"cubgctrl_cgroup_change_to_thaw_seconds", "Time from a cgroup change to the thaw (SIGCONT) it caused.", 1e-6},
+    {"cubgctrl_timer_task_duration_seconds", "Run time of one timer task.", 1e-6},
+    {"cubgctrl_timer_lateness_seconds", "Delay between a timer deadline and the start of its task.", 1e-6},
+};
+
+Metrics::Metrics() : shards_(), mtx_() { }
+
+Metrics::~Metrics() { }
+
+std::string Metrics::Export()
+{
+    uint64_t counters[METRIC_COUNTER_NUM]{};
+    uint64_t buckets[METRIC_HISTOGRAM_NUM][METRIC_HISTOGRAM_BUCKETS]{};
+    uint64_t sums[METRIC_HISTOGRAM_NUM]{};
+    {
+        std::unique_lock<std::mutex> lck(mtx_);
+        for (const auto &shard : shards_) {
+            for (int id = 0; id < METRIC_COUNTER_NUM; id++) {
+                counters[id] += shard->counters[id].load(std::memory_order_relaxed);
+            }
+            for (int id = 0; id < METRIC_HISTOGRAM_NUM; id++) {
+                const auto &histogram = shard->histograms[id];
+                for (int bucket = 0; bucket < METRIC_HISTOGRAM_BUCKETS; bucket++) {
+                    buckets[id][bucket] += histogram.buckets[bucket].load(std::memory_order_relaxed);
+                }
+                sums[id] += histogram.sum.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::string text{};
+    text.reserve(16 * 1024);
+    for (int id = 0; id < METRIC_COUNTER_NUM; id++) {
+        const auto &info = COUNTER_INFOS[id];
+        text += StrMerge("# HELP %s %s\n# TYPE %s counter\n%s %llu\n", info.name, info.help, info.name, info.name,
+            (unsigned long long)counters[id]);
+    }
+    for (int id = 0; id < METRIC_HISTOGRAM_NUM; id++) {
+        const auto &info = HISTOGRAM_INFOS[id];
+        text += StrMerge("# HELP %s %s\n# TYPE %s histogram\n", info.name, info.help, info.name);
+        // Prometheus buckets are cumulative, and the last one is always le="+Inf".
+        uint64_t count = 0;
+        for (int bucket = 0; bucket < METRIC_HISTOGRAM_BUCKETS - 1; bucket++) {
+            count += buckets[id][bucket];
+            text += StrMerge("%s_bucket{le=\"%g\"} %llu\n", info.name, (double)(1ULL << bucket) * info.scale,
+                (unsigned long long)count);
+        }
+        count += buckets[id][METRIC_HISTOGRAM_BUCKETS - 1];
+        text += StrMerge("%s_bucket{le=\"+Inf\"} %llu\n", info.name, (unsigned long long)count);
+        text += StrMerge("%s_sum %g\n%s_count %llu\n", info.name, (double)sums[id] * info.scale, info.name,
+            (unsigned long long)count);
+    }
+
+    return text;
+}
+
+Metrics::Shard* Metrics::CreateShard_()
+{
+    auto shard = new Shard();
+    std::unique_lock<std::mutex> lck(mtx_);
+    shards_.emplace_back(shard);
+
+    return shard;
+}
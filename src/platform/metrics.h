@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include "singleton.h"
+#include "utils/cu_misc.h"
+
+#define METRIC_CONTROLLER_PASSES 0
+#define METRIC_CONTROLLER_PIDS_SCANNED 1
+#define METRIC_CONTROLLER_KILLS 2
+#define METRIC_CONTROLLER_FREEZES 3
+#define METRIC_CONTROLLER_THAWS 4
+#define METRIC_CGROUP_EVENTS 5
+#define METRIC_CGROUP_NOTIFICATIONS 6
+#define METRIC_CONFIG_EVENTS 7
+#define METRIC_CONFIG_RELOADS 8
+#define METRIC_TIMER_RUNS 9
+#define METRIC_COUNTER_NUM 10
+
+#define METRIC_CONTROLLER_PASS_DURATION 0
+#define METRIC_CONTROLLER_PASS_IO_SYSCALLS 1
+#define METRIC_CGROUP_TO_THAW_LATENCY 2
+#define METRIC_TIMER_TASK_DURATION 3
+#define METRIC_TIMER_LATENESS 4
+#define METRIC_HISTOGRAM_NUM 5
+
+// Bucket b counts the values in (2^(b-1), 2^b], the last bucket also takes everything above.
+#define METRIC_HISTOGRAM_BUCKETS 32
+
+// Process-wide counters and log2-bucketed histograms.
+// Every thread updates its own shard with plain relaxed load/store pairs, so recording never takes a lock
+// or a locked instruction, and Export() sums the shards of all threads into Prometheus text format.
+// Shards are never freed, the totals of a thread that has exited keep counting.
+class Metrics : public Singleton<Metrics>
+{
+    public:
+        Metrics();
+        ~Metrics();
+
+        inline void AddCounter(const int &counterId, const uint64_t &value = 1)
+        {
+            auto &counter = GetShard_()->counters[counterId];
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        inline void Observe(const int &histogramId, const uint64_t &value)
+        {
+            auto &histogram = GetShard_()->histograms[histogramId];
+            auto &bucket = histogram.buckets[GetBucket_(value)];
+            bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            histogram.sum.store(histogram.sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        std::string Export();
+
+    private:
+        typedef struct {
+            std::atomic<uint64_t> buckets[METRIC_HISTOGRAM_BUCKETS];
+            std::atomic<uint64_t> sum;
+        } HistogramShard;
+
+        typedef struct {
+            std::atomic<uint64_t> counters[METRIC_COUNTER_NUM];
+            HistogramShard histograms[METRIC_HISTOGRAM_NUM];
+        } Shard;
+
+        std::vector<Shard*> shards_;
+        std::mutex mtx_;
+
+        inline Shard* GetShard_()
+        {
+            static thread_local Shard* shard = nullptr;
+            if (shard == nullptr) {
+                shard = CreateShard_();
+            }
+            return shard;
+        }
+
+        static inline int GetBucket_(const uint64_t &value)
+        {
+            int bucket = 0;
+            if (value > 1) {
+                bucket = std::min(64 - __builtin_clzll(value - 1), METRIC_HISTOGRAM_BUCKETS - 1);
+            }
+            return bucket;
+        }
+
+        Shard* CreateShard_();
+};
@@ -4,27 +4,32 @@ Module::Module() { }
 
 Module::~Module() { }
 
-void Module::Broadcast_SetBroadcastReceiver(const std::string &broadcastName, const Broadcast::BroadcastReceiver &br)
+void Module::Timer_AddTimer(const std::string &name, const Timer::TimerTask &task, const int &intervalMs, const int &mode)
 {
-	Broadcast::GetInstance()->SetBroadcastReceiver(broadcastName, br);
+	Timer::GetInstance()->AddTimer(name, task, intervalMs, mode);
 }
 
-void Module::Broadcast_SendBroadcast(const std::string &broadcastName, const void* data)
+void Module::Timer_DeleteTimer(const std::string &name)
 {
-	Broadcast::GetInstance()->SendBroadcast(broadcastName, data);
+	Timer::GetInstance()->DeleteTimer(name);
 }
 
-void Module::Timer_AddTimer(const std::string &name, const Timer::TimerTask &task, const int &intervalMs)
+bool Module::Timer_IsTimerExist(const std::string &name)
 {
-	Timer::GetInstance()->AddTimer(name, task, intervalMs);
+	return Timer::GetInstance()->IsTimerExist(name);
 }
 
-void Module::Timer_DeleteTimer(const std::string &name)
+bool Module::Reactor_AddFd(const int &fd, const uint32_t &events, const Reactor::FdCallback &callback)
 {
-	Timer::GetInstance()->DeleteTimer(name);
+	return Reactor::GetInstance()->AddFd(fd, events, callback);
 }
 
-bool Module::Timer_IsTimerExist(const std::string &name)
+void Module::Reactor_RemoveFd(const int &fd)
 {
-	return Timer::GetInstance()->IsTimerExist(name);
+	Reactor::GetInstance()->RemoveFd(fd);
 }
+
+void Module::Control_RegisterCommand(const std::string &command, const ControlServer::CommandHandler &handler)
+{
+	ControlServer::GetInstance()->RegisterCommand(command, handler);
+}
\ No newline at end of file
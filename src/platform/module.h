@@ -1,7 +1,10 @@
 #pragma once
 
-#include "platform/broadcast.h"
+#include "platform/event_bus.h"
 #include "platform/timer.h"
+#include "platform/reactor.h"
+#include "platform/metrics.h"
+#include "platform/control_server.h"
 
 class Module
 {
@@ -11,9 +14,22 @@ class Module
 		virtual void Start() = 0;
 
 	protected:
-		void Broadcast_SetBroadcastReceiver(const std::string &broadcastName, const Broadcast::BroadcastReceiver &br);
-		void Broadcast_SendBroadcast(const std::string &broadcastName, const void* data);
-		void Timer_AddTimer(const std::string &name, const Timer::TimerTask &task, const int &intervalMs);
+		template <typename TopicType>
+		void EventBus_Subscribe(const std::function<void(const typename TopicType::Payload &)> &receiver)
+		{
+			EventBus::GetInstance()->Subscribe<TopicType>(receiver);
+		}
+
+		template <typename TopicType>
+		void EventBus_Publish(typename TopicType::Payload payload)
+		{
+			EventBus::GetInstance()->Publish<TopicType>(std::move(payload));
+		}
+
+		void Timer_AddTimer(const std::string &name, const Timer::TimerTask &task, const int &intervalMs, const int &mode = TIMER_FIXED_RATE);
 		void Timer_DeleteTimer(const std::string &name);
 		bool Timer_IsTimerExist(const std::string &name);
+		bool Reactor_AddFd(const int &fd, const uint32_t &events, const Reactor::FdCallback &callback);
+		void Reactor_RemoveFd(const int &fd);
+		void Control_RegisterCommand(const std::string &command, const ControlServer::CommandHandler &handler);
 };
@@ -0,0 +1,82 @@
+#include "reactor.h"
+
+constexpr int MAX_EPOLL_EVENTS = 32;
+
+Reactor::Reactor() : epollFd_(-1), nextGeneration_(1), handlerMap_(), mtx_() 
+{
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+}
+
+Reactor::~Reactor() 
+{
+    if (epollFd_ >= 0) {
+        close(epollFd_);
+    }
+}
+
+bool Reactor::AddFd(const int &fd, const uint32_t &events, const FdCallback &callback)
+{
+    if (epollFd_ < 0 || fd < 0) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lck(mtx_);
+    if (handlerMap_.count(fd) == 1) {
+        return false;
+    }
+    FdHandler handler{};
+    handler.generation = nextGeneration_++;
+    handler.callback = std::make_shared<FdCallback>(callback);
+    struct epoll_event event{};
+    event.events = events;
+    event.data.u64 = ((uint64_t)handler.generation << 32) | (uint32_t)fd;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+        return false;
+    }
+    handlerMap_.emplace(fd, handler);
+
+    return true;
+}
+
+void Reactor::RemoveFd(const int &fd)
+{
+    std::unique_lock<std::mutex> lck(mtx_);
+    const auto &iter = handlerMap_.find(fd);
+    if (iter != handlerMap_.end()) {
+        epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+        handlerMap_.erase(iter);
+    }
+}
+
+void Reactor::Run()
+{
+    if (epollFd_ < 0) {
+        return;
+    }
+
+    for (;;) {
+        struct epoll_event events[MAX_EPOLL_EVENTS]{};
+        int eventNum = epoll_wait(epollFd_, events, MAX_EPOLL_EVENTS, -1);
+        if (eventNum < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        for (int i = 0; i < eventNum; i++) {
+            int fd = (int)(events[i].data.u64 & 0xFFFFFFFF);
+            uint32_t generation = (uint32_t)(events[i].data.u64 >> 32);
+            std::shared_ptr<FdCallback> callback = nullptr;
+            {
+                std::unique_lock<std::mutex> lck(mtx_);
+                const auto &iter = handlerMap_.find(fd);
+                if (iter != handlerMap_.end() && iter->second.generation == generation) {
+                    callback = iter->second.callback;
+                }
+            }
+            if (callback) {
+                (*callback)(events[i].events);
+            }
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <iostream>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <mutex>
+#include <cerrno>
+#include <sys/epoll.h>
+#include "singleton.h"
+#include "utils/cu_misc.h"
+
+// One epoll loop for every fd the daemon waits on (inotify, timerfd, eventfd, signalfd, netlink, pidfd).
+// Callbacks run on the thread that calls Run() without the lock held, so they may add or remove fds.
+// RemoveFd() must be called before the fd is closed; events still pending for a removed fd are dropped,
+// even if the fd number has been reused in the meantime.
+class Reactor : public Singleton<Reactor>
+{
+    public:
+        using FdCallback = std::function<void(uint32_t)>;
+
+        Reactor();
+        ~Reactor();
+        bool AddFd(const int &fd, const uint32_t &events, const FdCallback &callback);
+        void RemoveFd(const int &fd);
+        void Run();
+
+    private:
+        typedef struct {
+            uint32_t generation;
+            std::shared_ptr<FdCallback> callback;
+        } FdHandler;
+        int epollFd_;
+        uint32_t nextGeneration_;
+        std::unordered_map<int, FdHandler> handlerMap_;
+        std::mutex mtx_;
+};
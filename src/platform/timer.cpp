@@ -1,8 +1,31 @@
 #include "timer.h"
 
-Timer::Timer() : timerMap_() { }
+constexpr uint64_t NS_PER_US = 1000;
+constexpr uint64_t NS_PER_MS = 1000000;
+constexpr uint64_t NS_PER_SEC = 1000000000;
 
-void Timer::AddTimer(const std::string &name, const TimerTask &task, const int &intervalMs)
+Timer::Timer() : 
+    timerMap_(), 
+    eventHeap_(), 
+    nextTimerId_(1), 
+    armedNs_(UINT64_MAX), 
+    timerFd_(-1), 
+    mtx_()
+{
+    using namespace std::placeholders;
+    timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    Reactor::GetInstance()->AddFd(timerFd_, EPOLLIN, std::bind(&Timer::TimerExpired_, this, _1));
+}
+
+Timer::~Timer() 
+{
+    if (timerFd_ >= 0) {
+        Reactor::GetInstance()->RemoveFd(timerFd_);
+        close(timerFd_);
+    }
+}
+
+void Timer::AddTimer(const std::string &name, const TimerTask &task, const int &intervalMs, const int &mode)
 {
     std::unique_lock<std::mutex> lck(mtx_);
     if (timerMap_.count(name) == 1) {
@@ -11,25 +34,25 @@ void Timer::AddTimer(const std::string &name, const TimerTask &task, const int &
     {
         TimerData timerData{};
         timerData.task = task;
-        timerData.intervalMs = intervalMs;
+        timerData.intervalMs = intervalMs > 0 ? intervalMs : 1;
+        timerData.mode = mode;
+        timerData.timerId = nextTimerId_++;
         timerMap_[name] = timerData;
-    }
-    {
-        std::thread timerThread(std::bind(&Timer::TimerThread_, this, name));
-        timerThread.detach();
+        // The first run happens right away, same as before.
+        PushEvent_(GetTimeNs_(), timerData.timerId, name);
     }
 }
 
 void Timer::DeleteTimer(const std::string &name)
 {
+    // The heap entry stays behind and is dropped when it expires, its timerId no longer matches.
     std::unique_lock<std::mutex> lck(mtx_);
-    if (timerMap_.count(name) == 1) {
-        timerMap_.erase(name);
-    }
+    timerMap_.erase(name);
 }
 
 bool Timer::IsTimerExist(const std::string &name)
 {
+    std::unique_lock<std::mutex> lck(mtx_);
     bool exist = false;
     if (timerMap_.count(name) == 1) {
         exist = true;
@@ -38,23 +61,93 @@ bool Timer::IsTimerExist(const std::string &name)
     return exist;
 }
 
-void Timer::TimerThread_(const std::string &name) 
+void Timer::TimerExpired_(uint32_t)
 {
-    SetThreadName(StrMerge("Timer-%llu", timerMap_.size()));
+    {
+        uint64_t expirations = 0;
+        read(timerFd_, &expirations, sizeof(expirations));
+    }
+    {
+        std::unique_lock<std::mutex> lck(mtx_);
+        armedNs_ = UINT64_MAX;
+        while (!eventHeap_.empty()) {
+            uint64_t nowNs = GetTimeNs_();
+            if (eventHeap_.front().deadlineNs > nowNs) {
+                ArmTimerFd_(eventHeap_.front().deadlineNs);
+                break;
+            }
+            std::pop_heap(eventHeap_.begin(), eventHeap_.end(), CompareEvent_);
+            TimerEvent event = std::move(eventHeap_.back());
+            eventHeap_.pop_back();
 
-    std::string timerName = name;
-    for (;;) {
-        const auto &iter = timerMap_.find(timerName);
-        if (iter == timerMap_.end()) {
-            break;
-        }
-        auto data = iter->second;
-        {
-            const auto &task = data.task;
-            task();
+            const auto &iter = timerMap_.find(event.name);
+            if (iter == timerMap_.end() || iter->second.timerId != event.timerId) {
+                continue;
+            }
+            TimerTask task = iter->second.task;
+            lck.unlock();
+            {
+                const auto &metrics = Metrics::GetInstance();
+                metrics->Observe(METRIC_TIMER_LATENESS, (nowNs - event.deadlineNs) / NS_PER_US);
+                task();
+                metrics->Observe(METRIC_TIMER_TASK_DURATION, (GetTimeNs_() - nowNs) / NS_PER_US);
+                metrics->AddCounter(METRIC_TIMER_RUNS);
+            }
+            lck.lock();
+
+            // The timer may have been deleted or replaced while its task was running.
+            const auto &dataIter = timerMap_.find(event.name);
+            if (dataIter == timerMap_.end() || dataIter->second.timerId != event.timerId) {
+                continue;
+            }
+            const auto &data = dataIter->second;
+            uint64_t intervalNs = (uint64_t)data.intervalMs * NS_PER_MS;
+            uint64_t deadlineNs = 0;
+            if (data.mode == TIMER_FIXED_DELAY) {
+                deadlineNs = GetTimeNs_() + intervalNs;
+            } else {
+                // Skip the periods that were missed instead of running them back to back.
+                deadlineNs = event.deadlineNs + intervalNs;
+                nowNs = GetTimeNs_();
+                if (deadlineNs <= nowNs) {
+                    deadlineNs += ((nowNs - deadlineNs) / intervalNs + 1) * intervalNs;
+                }
+            }
+            PushEvent_(deadlineNs, event.timerId, event.name);
         }
-        usleep(data.intervalMs * 1000);
     }
 
     return;
 }
+
+void Timer::PushEvent_(const uint64_t &deadlineNs, const uint64_t &timerId, const std::string &name)
+{
+    eventHeap_.emplace_back(TimerEvent{deadlineNs, timerId, name});
+    std::push_heap(eventHeap_.begin(), eventHeap_.end(), CompareEvent_);
+    if (deadlineNs < armedNs_) {
+        ArmTimerFd_(deadlineNs);
+    }
+}
+
+void Timer::ArmTimerFd_(const uint64_t &deadlineNs)
+{
+    struct itimerspec its{};
+    // A zero it_value would disarm the timerfd, any deadline in the past fires at once anyway.
+    uint64_t armNs = deadlineNs > 0 ? deadlineNs : 1;
+    its.it_value.tv_sec = armNs / NS_PER_SEC;
+    its.it_value.tv_nsec = armNs % NS_PER_SEC;
+    timerfd_settime(timerFd_, TFD_TIMER_ABSTIME, &its, nullptr);
+    armedNs_ = deadlineNs;
+}
+
+bool Timer::CompareEvent_(const TimerEvent &a, const TimerEvent &b)
+{
+    return a.deadlineNs > b.deadlineNs;
+}
+
+uint64_t Timer::GetTimeNs_(void)
+{
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NS_PER_SEC + (uint64_t)ts.tv_nsec;
+}
@@ -4,19 +4,33 @@
 #include <functional>
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <algorithm>
 #include <utility>
-#include <thread>
 #include <mutex>
+#include <cerrno>
+#include <sys/timerfd.h>
 #include "singleton.h"
+#include "reactor.h"
+#include "metrics.h"
 #include "utils/cu_misc.h"
 
+// Next run is scheduled from the previous deadline, so periods don't drift with the task's run time.
+#define TIMER_FIXED_RATE 0
+// Next run is scheduled intervalMs after the task returns.
+#define TIMER_FIXED_DELAY 1
+
+// All timers share a min-heap of deadlines and one timerfd armed to the earliest one, which is polled by the Reactor.
+// Tasks run on the reactor thread without the lock held, a deleted timer never runs again once DeleteTimer returns
+// (a run that has already started is allowed to finish).
 class Timer : public Singleton<Timer> 
 {
     public:
         using TimerTask = std::function<void(void)>;
 
         Timer();
-        void AddTimer(const std::string &name, const TimerTask &task, const int &intervalMs);
+        ~Timer();
+        void AddTimer(const std::string &name, const TimerTask &task, const int &intervalMs, const int &mode = TIMER_FIXED_RATE);
         void DeleteTimer(const std::string &name);
         bool IsTimerExist(const std::string &name);
 
@@ -24,9 +38,24 @@ class Timer : public Singleton<Timer>
         typedef struct {
             TimerTask task;
             int intervalMs;
+            int mode;
+            uint64_t timerId;
         } TimerData;
+        typedef struct {
+            uint64_t deadlineNs;
+            uint64_t timerId;
+            std::string name;
+        } TimerEvent;
         std::unordered_map<std::string, TimerData> timerMap_;
+        std::vector<TimerEvent> eventHeap_;
+        uint64_t nextTimerId_;
+        uint64_t armedNs_;
+        int timerFd_;
         std::mutex mtx_;
 
-        void TimerThread_(const std::string &name);
+        void TimerExpired_(uint32_t events);
+        void PushEvent_(const uint64_t &deadlineNs, const uint64_t &timerId, const std::string &name);
+        void ArmTimerFd_(const uint64_t &deadlineNs);
+        static bool CompareEvent_(const TimerEvent &a, const TimerEvent &b);
+        static uint64_t GetTimeNs_(void);
 };
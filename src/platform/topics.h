@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "utils/process_table.h"
+
+// Every message of the topic is delivered.
+#define COALESCE_NONE 0
+// Only the newest payload queued for the topic is delivered.
+#define COALESCE_LATEST 1
+// Queued payloads are summed and delivered once, publishers post the number of occurrences.
+#define COALESCE_COUNTER 2
+
+template <int TopicId, typename PayloadType, int CoalescePolicy>
+struct Topic
+{
+    static constexpr int ID = TopicId;
+    static constexpr int POLICY = CoalescePolicy;
+    using Payload = PayloadType;
+};
+
+struct TopAppCgroupModifiedTopic : Topic<0, uint32_t, COALESCE_COUNTER> { };
+struct ForegroundCgroupModifiedTopic : Topic<1, uint32_t, COALESCE_COUNTER> { };
+struct BackgroundCgroupModifiedTopic : Topic<2, uint32_t, COALESCE_COUNTER> { };
+struct ScreenStateChangedTopic : Topic<3, int, COALESCE_LATEST> { };
+struct ConfigModifiedTopic : Topic<4, uint32_t, COALESCE_COUNTER> { };
+struct ProcStateChangedTopic : Topic<5, int, COALESCE_LATEST> { };
+struct TaskChangedTopic : Topic<6, std::vector<TaskEvent>, COALESCE_NONE> { };
+
+constexpr int TOPIC_NUM = 7;
@@ -4,3 +4,219 @@ CuLogger* CuLogger::instance_ = nullptr;
 std::once_flag CuLogger::flag_;
 std::string CuLogger::logPath_ = CuLogger::LOG_PATH_NONE;
 int CuLogger::logLevel_ = CuLogger::LOG_NONE;
+
+constexpr size_t LOG_WRITE_BUFFER_SIZE = 64 * 1024;
+constexpr int LOG_FLUSH_TIMEOUT_MS = 1000;
+
+CuLogger::CuLogger() : 
+	slots_(nullptr), 
+	enqueuePos_(0), 
+	dequeuePos_(0), 
+	writtenPos_(0), 
+	droppedCount_(0), 
+	writerSleeping_(false), 
+	writerMtx_(), 
+	writerCv_(), 
+	writerThread_(), 
+	writerStarted_(false), 
+	logFd_(-1), 
+	fullPolicy_(LOG_FULL_DROP), 
+	maxLogSize_(DEFAULT_MAX_LOG_SIZE), 
+	logSize_(0) { }
+
+void CuLogger::OpenLog_(const int &fullPolicy, const size_t &maxLogSize)
+{
+	logFd_ = open(logPath_.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+	if (logFd_ < 0) {
+		logLevel_ = LOG_NONE;
+		return;
+	}
+	slots_ = new LogSlot[LOG_RING_SLOTS];
+	for (size_t idx = 0; idx < LOG_RING_SLOTS; idx++) {
+		slots_[idx].seq.store(idx, std::memory_order_relaxed);
+	}
+	fullPolicy_ = fullPolicy;
+	maxLogSize_ = maxLogSize;
+}
+
+void CuLogger::StartWriter()
+{
+	if (slots_ == nullptr || writerStarted_) {
+		return;
+	}
+
+	writerStarted_ = true;
+	writerThread_ = std::thread(std::bind(&CuLogger::WriterMain_, this));
+	writerThread_.detach();
+	// std::exit() paths after an Error() still get their last records on disk.
+	atexit([]() {
+		instance_->Flush();
+	});
+}
+
+void CuLogger::Flush()
+{
+	if (slots_ == nullptr || !writerStarted_) {
+		return;
+	}
+
+	uint64_t targetPos = enqueuePos_.load(std::memory_order_acquire);
+	for (int waitedMs = 0; waitedMs < LOG_FLUSH_TIMEOUT_MS; waitedMs++) {
+		if (writtenPos_.load(std::memory_order_acquire) >= targetPos) {
+			break;
+		}
+		WakeWriter_();
+		usleep(1000);
+	}
+}
+
+uint64_t CuLogger::GetDroppedCount() const
+{
+	return droppedCount_.load(std::memory_order_relaxed);
+}
+
+void CuLogger::WriteLogV_(const char &tag, const char* format, va_list arg)
+{
+	// "MM-DD HH:MM:SS [T] text\n", formatted once into a per-thread buffer.
+	thread_local char buffer[LOG_RECORD_SIZE];
+	size_t len = FormatTimeInfo_(buffer, sizeof(buffer));
+	len += snprintf(buffer + len, sizeof(buffer) - len, " [%c] ", tag);
+	int textLen = vsnprintf(buffer + len, sizeof(buffer) - len, format, arg);
+	if (textLen > 0) {
+		len = std::min(len + (size_t)textLen, sizeof(buffer) - 2);
+	}
+	buffer[len++] = '\n';
+	WriteLog_(buffer, len);
+}
+
+size_t CuLogger::FormatTimeInfo_(char* buffer, const size_t &size)
+{
+	// localtime_r is only called when the second changes.
+	thread_local time_t cachedTime = -1;
+	thread_local char cachedTimeInfo[16] = { 0 };
+	thread_local size_t cachedLen = 0;
+
+	time_t timeStamp = time(nullptr);
+	if (timeStamp != cachedTime) {
+		struct tm time{};
+		localtime_r(&timeStamp, &time);
+		int len = snprintf(cachedTimeInfo, sizeof(cachedTimeInfo), "%02d-%02d %02d:%02d:%02d", 
+			time.tm_mon + 1, time.tm_mday, time.tm_hour, time.tm_min, time.tm_sec);
+		cachedLen = len > 0 ? std::min((size_t)len, sizeof(cachedTimeInfo) - 1) : 0;
+		cachedTime = timeStamp;
+	}
+	size_t len = std::min(cachedLen, size - 1);
+	memcpy(buffer, cachedTimeInfo, len);
+	buffer[len] = '\0';
+
+	return len;
+}
+
+void CuLogger::WriteLog_(const char* text, const size_t &len)
+{
+	if (slots_ == nullptr) {
+		return;
+	}
+
+	// Bounded MPMC ring (Vyukov), a slot is free for position pos when its seq equals pos.
+	LogSlot* slot = nullptr;
+	uint64_t pos = enqueuePos_.load(std::memory_order_relaxed);
+	for (;;) {
+		slot = &slots_[pos % LOG_RING_SLOTS];
+		uint64_t seq = slot->seq.load(std::memory_order_acquire);
+		int64_t diff = (int64_t)seq - (int64_t)pos;
+		if (diff == 0) {
+			if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (diff < 0) {
+			if (fullPolicy_ == LOG_FULL_DROP) {
+				droppedCount_.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			WakeWriter_();
+			usleep(100);
+			pos = enqueuePos_.load(std::memory_order_relaxed);
+		} else {
+			pos = enqueuePos_.load(std::memory_order_relaxed);
+		}
+	}
+	slot->len = std::min(len, sizeof(slot->text));
+	memcpy(slot->text, text, slot->len);
+	slot->seq.store(pos + 1, std::memory_order_release);
+
+	if (writerSleeping_.load(std::memory_order_seq_cst)) {
+		WakeWriter_();
+	}
+}
+
+void CuLogger::WakeWriter_()
+{
+	if (writerSleeping_.exchange(false, std::memory_order_seq_cst)) {
+		std::unique_lock<std::mutex> lck(writerMtx_);
+		writerCv_.notify_one();
+	}
+}
+
+void CuLogger::WriterMain_()
+{
+	char* buffer = new char[LOG_WRITE_BUFFER_SIZE];
+	size_t bufferLen = 0;
+	uint64_t droppedReported = 0;
+	for (;;) {
+		LogSlot* slot = &slots_[dequeuePos_ % LOG_RING_SLOTS];
+		uint64_t seq = slot->seq.load(std::memory_order_acquire);
+		if (seq == dequeuePos_ + 1 && bufferLen + slot->len <= LOG_WRITE_BUFFER_SIZE) {
+			memcpy(buffer + bufferLen, slot->text, slot->len);
+			bufferLen += slot->len;
+			slot->seq.store(dequeuePos_ + LOG_RING_SLOTS, std::memory_order_release);
+			dequeuePos_++;
+			continue;
+		}
+
+		// The ring is empty or the batch is full, write what has been collected so far.
+		if (bufferLen > 0) {
+			ssize_t len = write(logFd_, buffer, bufferLen);
+			if (len > 0) {
+				logSize_ += len;
+			}
+			bufferLen = 0;
+			writtenPos_.store(dequeuePos_, std::memory_order_release);
+			if (logSize_ >= maxLogSize_) {
+				RotateLog_();
+			}
+			continue;
+		}
+		uint64_t dropped = droppedCount_.load(std::memory_order_relaxed);
+		if (dropped != droppedReported) {
+			char text[64] = { 0 };
+			size_t len = FormatTimeInfo_(text, sizeof(text));
+			len += snprintf(text + len, sizeof(text) - len, " [W] %llu log records dropped.\n", 
+				(unsigned long long)(dropped - droppedReported));
+			write(logFd_, text, std::min(len, sizeof(text) - 1));
+			droppedReported = dropped;
+		}
+
+		std::unique_lock<std::mutex> lck(writerMtx_);
+		writerSleeping_.store(true, std::memory_order_seq_cst);
+		seq = slots_[dequeuePos_ % LOG_RING_SLOTS].seq.load(std::memory_order_acquire);
+		if (seq == dequeuePos_ + 1) {
+			writerSleeping_.store(false, std::memory_order_seq_cst);
+			continue;
+		}
+		writerCv_.wait_for(lck, std::chrono::seconds(1));
+		writerSleeping_.store(false, std::memory_order_seq_cst);
+	}
+}
+
+void CuLogger::RotateLog_()
+{
+	const std::string oldLogPath = logPath_ + ".1";
+	rename(logPath_.c_str(), oldLogPath.c_str());
+	int logFd = open(logPath_.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (logFd >= 0) {
+		close(logFd_);
+		logFd_ = logFd;
+		logSize_ = 0;
+	}
+}
@@ -15,19 +15,53 @@
 #include <stdexcept>
 #include <memory>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
 #include <string>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Calls more verbose than CU_LOG_COMPILE_LEVEL are compiled out, the CU_LOG* macros also skip evaluating
+// their arguments when the level is disabled at runtime.
+#ifndef CU_LOG_COMPILE_LEVEL
+#define CU_LOG_COMPILE_LEVEL 3
+#endif
+
+#define CU_LOG_(level, method, ...) \
+	do { \
+		if ((level) <= CU_LOG_COMPILE_LEVEL && CuLogger::IsLevelEnabled(level)) { \
+			CuLogger::GetLogger()->method(__VA_ARGS__); \
+		} \
+	} while (0)
+#define CU_LOGE(...) CU_LOG_(CuLogger::LOG_ERROR, Error, __VA_ARGS__)
+#define CU_LOGW(...) CU_LOG_(CuLogger::LOG_WARNING, Warning, __VA_ARGS__)
+#define CU_LOGI(...) CU_LOG_(CuLogger::LOG_INFO, Info, __VA_ARGS__)
+#define CU_LOGD(...) CU_LOG_(CuLogger::LOG_DEBUG, Debug, __VA_ARGS__)
 
 class CuLogger
 {
 	public:
 		static constexpr char LOG_PATH_NONE[] = "NONE";
+		static constexpr size_t LOG_RECORD_SIZE = 512;
 		static constexpr int LOG_NONE = -1;
 		static constexpr int LOG_ERROR = 0;
 		static constexpr int LOG_WARNING = 1;
 		static constexpr int LOG_INFO = 2;
 		static constexpr int LOG_DEBUG = 3;
-
-		static void CreateLogger(const int &logLevel, const std::string &logPath)
+		static constexpr int LOG_FULL_DROP = 0;
+		static constexpr int LOG_FULL_BLOCK = 1;
+		static constexpr size_t DEFAULT_MAX_LOG_SIZE = 4 * 1024 * 1024;
+
+		// Records are queued in a ring buffer and written in batches by a writer thread, which is only
+		// started by StartWriter() so that it can be called after daemon() forks.
+		// fullPolicy decides whether a record is dropped or the caller waits when the ring is full,
+		// log.txt is moved to log.txt.1 once it grows past maxLogSize.
+		static void CreateLogger(const int &logLevel, const std::string &logPath, 
+			const int &fullPolicy = LOG_FULL_DROP, const size_t &maxLogSize = DEFAULT_MAX_LOG_SIZE)
 		{
 			if (instance_ != nullptr) {
 				throw std::runtime_error("Logger already exist.");
@@ -39,6 +73,7 @@ class CuLogger
 			if (logLevel_ != LOG_NONE) {
 				if (CreateLog_(logPath)) {
 					logPath_ = logPath;
+					instance_->OpenLog_(fullPolicy, maxLogSize);
 				} else {
 					logLevel_ = LOG_NONE;
 				}
@@ -61,96 +96,83 @@ class CuLogger
 			}
 		}
 
-		void Error(const char* format, ...) const
+		static bool IsLevelEnabled(const int &logLevel)
+		{
+			return logLevel_ >= logLevel;
+		}
+
+		// Starts the writer thread, records queued before this call are written once it runs.
+		// Must be called in the process that keeps logging, a fork never carries the writer over.
+		void StartWriter();
+		// Waits until every queued record is written, used on fatal paths before exiting.
+		void Flush();
+		uint64_t GetDroppedCount() const;
+
+		void Error(const char* format, ...) __attribute__((format(printf, 2, 3)))
 		{
-			std::string logText = "";
-			{
+			if (LOG_ERROR <= CU_LOG_COMPILE_LEVEL && logLevel_ >= LOG_ERROR) {
 				va_list arg;
 				va_start(arg, format);
-				int size = vsnprintf(nullptr, 0, format, arg);
+				WriteLogV_('E', format, arg);
 				va_end(arg);
-				if (size > 0) {
-					logText.resize((size_t)size + 1);
-					va_start(arg, format);
-					vsnprintf(&logText[0], logText.size(), format, arg);
-					va_end(arg);
-				}
-				logText.resize(strlen(logText.c_str()));
-			}
-			if (logLevel_ >= LOG_ERROR) {
-				logText = GetTimeInfo_() + " [E] " + logText + "\n";
-				WriteLog_(logText);
 			}
 		}
 
-		void Warning(const char* format, ...) const
+		void Warning(const char* format, ...) __attribute__((format(printf, 2, 3)))
 		{
-			std::string logText = "";
-			{
+			if (LOG_WARNING <= CU_LOG_COMPILE_LEVEL && logLevel_ >= LOG_WARNING) {
 				va_list arg;
 				va_start(arg, format);
-				int size = vsnprintf(nullptr, 0, format, arg);
+				WriteLogV_('W', format, arg);
 				va_end(arg);
-				if (size > 0) {
-					logText.resize((size_t)size + 1);
-					va_start(arg, format);
-					vsnprintf(&logText[0], logText.size(), format, arg);
-					va_end(arg);
-				}
-				logText.resize(strlen(logText.c_str()));
-			}
-			if (logLevel_ >= LOG_WARNING) {
-				logText = GetTimeInfo_() + " [W] " + logText + "\n";
-				WriteLog_(logText);
 			}
 		}
 
-		void Info(const char* format, ...) const
+		void Info(const char* format, ...) __attribute__((format(printf, 2, 3)))
 		{
-			std::string logText = "";
-			{
+			if (LOG_INFO <= CU_LOG_COMPILE_LEVEL && logLevel_ >= LOG_INFO) {
 				va_list arg;
 				va_start(arg, format);
-				int size = vsnprintf(nullptr, 0, format, arg);
+				WriteLogV_('I', format, arg);
 				va_end(arg);
-				if (size > 0) {
-					logText.resize((size_t)size + 1);
-					va_start(arg, format);
-					vsnprintf(&logText[0], logText.size(), format, arg);
-					va_end(arg);
-				}
-				logText.resize(strlen(logText.c_str()));
-			}
-			if (logLevel_ >= LOG_INFO) {
-				logText = GetTimeInfo_() + " [I] " + logText + "\n";
-				WriteLog_(logText);
 			}
 		}
 
-		void Debug(const char* format, ...) const
+		void Debug(const char* format, ...) __attribute__((format(printf, 2, 3)))
 		{
-			std::string logText = "";
-			{
+			if (LOG_DEBUG <= CU_LOG_COMPILE_LEVEL && logLevel_ >= LOG_DEBUG) {
 				va_list arg;
 				va_start(arg, format);
-				int size = vsnprintf(nullptr, 0, format, arg);
+				WriteLogV_('D', format, arg);
 				va_end(arg);
-				if (size > 0) {
-					logText.resize((size_t)size + 1);
-					va_start(arg, format);
-					vsnprintf(&logText[0], logText.size(), format, arg);
-					va_end(arg);
-				}
-				logText.resize(strlen(logText.c_str()));
-			}
-			if (logLevel_ >= LOG_DEBUG) {
-				logText = GetTimeInfo_() + " [D] " + logText + "\n";
-				WriteLog_(logText);
 			}
 		}
 
 	private:
-		CuLogger() = default;
+		typedef struct {
+			std::atomic<uint64_t> seq;
+			size_t len;
+			char text[LOG_RECORD_SIZE];
+		} LogSlot;
+
+		static constexpr size_t LOG_RING_SLOTS = 1024;
+
+		LogSlot* slots_;
+		std::atomic<uint64_t> enqueuePos_;
+		uint64_t dequeuePos_;
+		std::atomic<uint64_t> writtenPos_;
+		std::atomic<uint64_t> droppedCount_;
+		std::atomic<bool> writerSleeping_;
+		std::mutex writerMtx_;
+		std::condition_variable writerCv_;
+		std::thread writerThread_;
+		bool writerStarted_;
+		int logFd_;
+		int fullPolicy_;
+		size_t maxLogSize_;
+		size_t logSize_;
+
+		CuLogger();
 		CuLogger(const CuLogger&) = delete;
 		CuLogger &operator=(const CuLogger&) = delete;
 
@@ -173,27 +195,13 @@ class CuLogger
 			return created;
 		}
 
-		void WriteLog_(const std::string &text) const
-		{
-			FILE* fp = fopen(logPath_.c_str(), "a");
-			if (fp) {
-				fputs(text.c_str(), fp);
-				fflush(fp);
-				fclose(fp);
-			}
-		}
-
-		std::string GetTimeInfo_() const
-		{
-			std::string timeInfo = std::string(16, '\0');
-			time_t time_stamp = time(nullptr);
-			struct tm time = *localtime(&time_stamp);
-			snprintf(&timeInfo[0], timeInfo.size(), "%02d-%02d %02d:%02d:%02d",
-					time.tm_mon + 1, time.tm_mday, time.tm_hour, time.tm_min, time.tm_sec);
-			timeInfo.resize(strlen(timeInfo.c_str()));
-
-			return timeInfo;
-		}
+		void OpenLog_(const int &fullPolicy, const size_t &maxLogSize);
+		void WriteLogV_(const char &tag, const char* format, va_list arg);
+		void WriteLog_(const char* text, const size_t &len);
+		static size_t FormatTimeInfo_(char* buffer, const size_t &size);
+		void WriterMain_();
+		void WakeWriter_();
+		void RotateLog_();
 
 		static CuLogger* instance_;
 		static std::once_flag flag_;
@@ -50,7 +50,7 @@ std::string ReadFile(const std::string &filePath)
     }
     if (fd >= 0) {
         char buffer[4096] = { 0 };
-        size_t len = read(fd, buffer, sizeof(buffer));
+        ssize_t len = read(fd, buffer, sizeof(buffer) - 1);
         if (len >= 0) {
             buffer[len] = '\0';
         } else {
@@ -262,7 +262,7 @@ int GetThreadPid(const int &tid)
     int fd = open(statusPath, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
     if (fd >= 0) {
         char buffer[4096] = { 0 };
-        size_t len = read(fd, buffer, sizeof(buffer));
+        ssize_t len = read(fd, buffer, sizeof(buffer) - 1);
         char lineStr[128] = { 0 };
         int start_p = 0;
         for (int i = 0; i < len; i++) {
@@ -316,25 +316,33 @@ int GetTaskType(const int &pid)
         read(fd, buffer, sizeof(buffer));
         int oom_adj = 16;
         sscanf(buffer, "%d", &oom_adj);
-        if (oom_adj == 0) {
-            taskType = TASK_FOREGROUND;
-        } else if (oom_adj == 1) {
-            taskType = TASK_VISIBLE;
-        } else if (oom_adj >= 2 && oom_adj <= 8) {
-            taskType = TASK_SERVICE;
-        } else if (oom_adj <= -1 && oom_adj >= -17) {
-            taskType = TASK_SYSTEM;
-        } else if (oom_adj >= 9 && oom_adj <= 14) {
-            taskType = TASK_BACKGROUND;
-        } else if (oom_adj == 15 || oom_adj == 16) {
-            taskType = TASK_KILLABLE;
-        }
+        taskType = OomAdjToTaskType(oom_adj);
         close(fd);
     }
 
     return taskType;
 }
 
+int OomAdjToTaskType(const int &oomAdj)
+{
+    int taskType = TASK_OTHER;
+    if (oomAdj == 0) {
+        taskType = TASK_FOREGROUND;
+    } else if (oomAdj == 1) {
+        taskType = TASK_VISIBLE;
+    } else if (oomAdj >= 2 && oomAdj <= 8) {
+        taskType = TASK_SERVICE;
+    } else if (oomAdj <= -1 && oomAdj >= -17) {
+        taskType = TASK_SYSTEM;
+    } else if (oomAdj >= 9 && oomAdj <= 14) {
+        taskType = TASK_BACKGROUND;
+    } else if (oomAdj == 15 || oomAdj == 16) {
+        taskType = TASK_KILLABLE;
+    }
+
+    return taskType;
+}
+
 std::string GetTaskName(const int &pid)
 {
     std::string ret = ""; 
@@ -344,7 +352,7 @@ std::string GetTaskName(const int &pid)
     int fd = open(cmdlinePath, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
     if (fd >= 0) {
         char buffer[4096] = { 0 };
-        size_t len = read(fd, buffer, sizeof(buffer));
+        ssize_t len = read(fd, buffer, sizeof(buffer) - 1);
         if (len >= 0) {
             buffer[len] = '\0';
         } else {
@@ -366,7 +374,7 @@ std::string GetTaskComm(const int &pid)
     int fd = open(cmdlinePath, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
     if (fd >= 0) {
         char buffer[4096] = { 0 };
-        size_t len = read(fd, buffer, sizeof(buffer));
+        ssize_t len = read(fd, buffer, sizeof(buffer) - 1);
         if (len >= 0) {
             buffer[len] = '\0';
         } else {
@@ -411,7 +419,7 @@ int GetScreenStateViaCgroup(void)
     int fd = open("/dev/cpuset/restricted/tasks", O_RDONLY | O_NONBLOCK | O_CLOEXEC);
     if (fd >= 0) {
         char buffer[4096] = { 0 };
-        size_t len = read(fd, buffer, sizeof(buffer));
+        ssize_t len = read(fd, buffer, sizeof(buffer) - 1);
         int restrictedTaskNum = 0;
         for (int i = 0; i < len; i++) {
             if (buffer[i] == '\n') {
@@ -560,6 +568,13 @@ uint64_t GetTimeStampMs(void)
     return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
 }
 
+uint64_t GetTimeStampUs(void) 
+{
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
 int StringToInteger(const std::string &str)
 {
     int integer = 0;
@@ -688,3 +703,33 @@ std::string TrimStr(const std::string &str)
 
     return trimedStr;
 }
+
+bool StringToInt64(const std::string &str, int64_t* value)
+{
+    // Unlike StringToLong(), the whole string (blanks around it aside) must be one decimal number.
+    const char* begin = str.c_str();
+    while (*begin == ' ' || *begin == '\t') {
+        begin++;
+    }
+    char* end = nullptr;
+    errno = 0;
+    long long integer = strtoll(begin, &end, 10);
+    if (end == begin || errno == ERANGE) {
+        return false;
+    }
+    while (*end == ' ' || *end == '\t' || *end == '\r' || *end == '\n') {
+        end++;
+    }
+    if (*end != '\0') {
+        return false;
+    }
+    *value = (int64_t)integer;
+
+    return true;
+}
+
+std::string StripConfigComment(const std::string &line)
+{
+    // Everything after '#' is a comment, also at the end of a rule or an option.
+    return line.substr(0, line.find('#'));
+}
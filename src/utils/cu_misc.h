@@ -9,6 +9,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <climits>
+#include <cerrno>
 #include <ctime>
 #include <cstdarg>
 #include <cstring>
@@ -32,6 +33,7 @@
 #define TASK_SYSTEM 3
 #define TASK_BACKGROUND 4
 #define TASK_KILLABLE 5
+#define TASK_TYPE_NUM 7
 
 void CreateFile(const std::string &filePath, const std::string &str);
 void AppendFile(const std::string &filePath, const std::string &str);
@@ -51,6 +53,7 @@ std::string DumpTopActivityInfo(void);
 bool IsPathExist(const std::string &path);
 int GetThreadPid(const int &tid);
 int GetTaskType(const int &pid);
+int OomAdjToTaskType(const int &oomAdj);
 std::string GetTaskName(const int &pid);
 std::string GetTaskComm(const int &pid);
 unsigned long int GetThreadRuntime(const int &pid, const int &tid);
@@ -63,7 +66,10 @@ int GetAndroidSDKVersion(void);
 int GetLinuxKernelVersion(void);
 int FindTaskPid(const std::string &taskName);
 uint64_t GetTimeStampMs(void);
+uint64_t GetTimeStampUs(void);
 int StringToInteger(const std::string &str);
 uint64_t StringToLong(const std::string &str);
 uint64_t String16BitToInteger(const std::string &str);
 std::string TrimStr(const std::string &str);
+bool StringToInt64(const std::string &str, int64_t* value);
+std::string StripConfigComment(const std::string &line);
@@ -0,0 +1,84 @@
+#include "debouncer.h"
+
+Debouncer::Debouncer(const uint64_t &leadingMs, const uint64_t &trailingMs, const uint64_t &maxLatencyMs) : 
+    leadingMs_(leadingMs),
+    trailingMs_(trailingMs),
+    maxLatencyMs_(maxLatencyMs),
+    pending_(false),
+    eventNum_(0),
+    firstEventMs_(0),
+    deadlineMs_(0),
+    lastActionMs_(0),
+    stats_(),
+    mtx_(),
+    cv_() { }
+
+Debouncer::~Debouncer() { }
+
+void Debouncer::Notify()
+{
+    uint64_t nowMs = GetTimeStampMs();
+
+    std::unique_lock<std::mutex> lck(mtx_);
+    if (!pending_) {
+        pending_ = true;
+        eventNum_ = 1;
+        firstEventMs_ = nowMs;
+        // Events right after an action belong to the same burst, so they get the trailing delay.
+        if (lastActionMs_ != 0 && nowMs - lastActionMs_ < trailingMs_) {
+            deadlineMs_ = nowMs + trailingMs_;
+        } else {
+            deadlineMs_ = nowMs + leadingMs_;
+        }
+    } else {
+        eventNum_++;
+        deadlineMs_ = std::max(deadlineMs_, nowMs + trailingMs_);
+    }
+    deadlineMs_ = std::min(deadlineMs_, firstEventMs_ + maxLatencyMs_);
+    cv_.notify_all();
+}
+
+Debouncer::Action Debouncer::Wait(const uint64_t &deadlineMs)
+{
+    std::unique_lock<std::mutex> lck(mtx_);
+    for (;;) {
+        uint64_t nowMs = GetTimeStampMs();
+        uint64_t wakeupMs = deadlineMs;
+        if (pending_) {
+            wakeupMs = std::min(wakeupMs, deadlineMs_);
+        }
+        if (nowMs >= wakeupMs) {
+            break;
+        }
+        if (wakeupMs == UINT64_MAX) {
+            cv_.wait(lck);
+        } else {
+            cv_.wait_for(lck, std::chrono::milliseconds(wakeupMs - nowMs));
+        }
+    }
+
+    uint64_t nowMs = GetTimeStampMs();
+    Action action{};
+    if (!pending_ || nowMs < deadlineMs_) {
+        action.eventNum = 0;
+        action.latencyMs = 0;
+        return action;
+    }
+    action.eventNum = eventNum_;
+    action.latencyMs = nowMs - firstEventMs_;
+    pending_ = false;
+    lastActionMs_ = nowMs;
+
+    stats_.actionNum++;
+    stats_.eventNum += action.eventNum;
+    stats_.totalLatencyMs += action.latencyMs;
+    stats_.maxLatencyMs = std::max(stats_.maxLatencyMs, action.latencyMs);
+
+    return action;
+}
+
+Debouncer::Stats Debouncer::GetStats()
+{
+    std::unique_lock<std::mutex> lck(mtx_);
+    return stats_;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include "utils/cu_misc.h"
+
+// Coalesces wakeup events for a single consumer thread.
+// An isolated event is handled after leadingMs; further events arriving before the action
+// push it back to lastEvent + trailingMs, but never beyond firstEvent + maxLatencyMs.
+// Wait() also returns at an optional absolute deadline, with eventNum 0.
+class Debouncer
+{
+    public:
+        typedef struct {
+            uint64_t eventNum;
+            uint64_t latencyMs;
+        } Action;
+
+        typedef struct {
+            uint64_t actionNum;
+            uint64_t eventNum;
+            uint64_t totalLatencyMs;
+            uint64_t maxLatencyMs;
+        } Stats;
+
+        Debouncer(const uint64_t &leadingMs, const uint64_t &trailingMs, const uint64_t &maxLatencyMs);
+        ~Debouncer();
+        void Notify();
+        Action Wait(const uint64_t &deadlineMs = UINT64_MAX);
+        Stats GetStats();
+
+    private:
+        uint64_t leadingMs_;
+        uint64_t trailingMs_;
+        uint64_t maxLatencyMs_;
+        bool pending_;
+        uint64_t eventNum_;
+        uint64_t firstEventMs_;
+        uint64_t deadlineMs_;
+        uint64_t lastActionMs_;
+        Stats stats_;
+        std::mutex mtx_;
+        std::condition_variable cv_;
+};
@@ -0,0 +1,46 @@
+#include "file_reader.h"
+
+constexpr size_t DEFAULT_BUFFER_SIZE = 4096;
+
+FileReader::FileReader() : buffer_(DEFAULT_BUFFER_SIZE), dataLen_(0) { }
+
+FileReader::FileReader(const size_t &initSize) : buffer_(initSize > 0 ? initSize : DEFAULT_BUFFER_SIZE), dataLen_(0) { }
+
+FileReader::~FileReader() { }
+
+bool FileReader::Read(const std::string &filePath)
+{
+    bool ret = false;
+    dataLen_ = 0;
+
+    int fd = open(filePath.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        chmod(filePath.c_str(), 0666);
+        fd = open(filePath.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    }
+    if (fd >= 0) {
+        for (;;) {
+            if (dataLen_ == buffer_.size()) {
+                buffer_.resize(buffer_.size() * 2);
+            }
+            ssize_t len = read(fd, buffer_.data() + dataLen_, buffer_.size() - dataLen_);
+            if (len > 0) {
+                dataLen_ += len;
+            } else if (len == 0) {
+                ret = true;
+                break;
+            } else if (errno != EINTR) {
+                dataLen_ = 0;
+                break;
+            }
+        }
+        close(fd);
+    }
+
+    return ret;
+}
+
+std::string_view FileReader::GetData() const
+{
+    return std::string_view(buffer_.data(), dataLen_);
+}
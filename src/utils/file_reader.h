@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cerrno>
+#include "utils/cu_misc.h"
+
+// Reads a whole kernel file into a reusable buffer, looping until EOF and growing the buffer as needed,
+// so long lists like cgroup.procs are never cut off and steady-state reads don't allocate.
+class FileReader
+{
+    public:
+        FileReader();
+        FileReader(const size_t &initSize);
+        ~FileReader();
+        bool Read(const std::string &filePath);
+        std::string_view GetData() const;
+
+        // Calls func(std::string_view) for every non-empty line.
+        template <typename Func>
+        bool ForEachLine(const std::string &filePath, const Func &func)
+        {
+            bool ret = Read(filePath);
+            if (ret) {
+                const char* data = buffer_.data();
+                size_t lineStart = 0;
+                for (size_t pos = 0; pos <= dataLen_; pos++) {
+                    if (pos == dataLen_ || data[pos] == '\n') {
+                        if (pos > lineStart) {
+                            func(std::string_view(data + lineStart, pos - lineStart));
+                        }
+                        lineStart = pos + 1;
+                    }
+                }
+            }
+
+            return ret;
+        }
+
+        // Calls func(int) for every decimal integer, any other character acts as a separator.
+        template <typename Func>
+        bool ForEachInteger(const std::string &filePath, const Func &func)
+        {
+            bool ret = Read(filePath);
+            if (ret) {
+                const char* data = buffer_.data();
+                int integer = 0;
+                bool inNumber = false;
+                for (size_t pos = 0; pos < dataLen_; pos++) {
+                    unsigned int digit = (unsigned char)data[pos] - '0';
+                    if (digit < 10) {
+                        integer = integer * 10 + (int)digit;
+                        inNumber = true;
+                    } else if (inNumber) {
+                        func(integer);
+                        integer = 0;
+                        inNumber = false;
+                    }
+                }
+                if (inNumber) {
+                    func(integer);
+                }
+            }
+
+            return ret;
+        }
+
+    private:
+        std::vector<char> buffer_;
+        size_t dataLen_;
+};
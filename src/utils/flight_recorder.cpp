@@ -0,0 +1,168 @@
+#include "flight_recorder.h"
+
+constexpr char TRACE_MAGIC[8] = { 'C', 'U', 'T', 'R', 'A', 'C', 'E', '1' };
+constexpr uint32_t TRACE_VERSION = 1;
+constexpr size_t TRACE_HEADER_SIZE = 64;
+
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord must stay 32 bytes.");
+
+static const char* GetTaskTypeName_(const int &taskType)
+{
+    switch (taskType) {
+        case TASK_FOREGROUND:
+            return "foreground";
+        case TASK_VISIBLE:
+            return "visible";
+        case TASK_SERVICE:
+            return "service";
+        case TASK_SYSTEM:
+            return "system";
+        case TASK_BACKGROUND:
+            return "background";
+        case TASK_KILLABLE:
+            return "killable";
+        default:
+            break;
+    }
+
+    return "other";
+}
+
+static const char* GetDecisionName_(const int &decision)
+{
+    switch (decision) {
+        case TRACE_DECISION_KILL:
+            return "kill";
+        case TRACE_DECISION_FREEZE:
+            return "freeze";
+        case TRACE_DECISION_GRACE:
+            return "grace";
+        case TRACE_DECISION_KEEP:
+            return "keep";
+        case TRACE_DECISION_THAW:
+            return "thaw";
+        default:
+            break;
+    }
+
+    return "none";
+}
+
+FlightRecorder::FlightRecorder() : header_(nullptr), records_(nullptr), mapSize_(0) { }
+
+FlightRecorder::~FlightRecorder()
+{
+    if (header_ != nullptr) {
+        munmap(header_, mapSize_);
+    }
+}
+
+bool FlightRecorder::Open(const std::string &tracePath, const size_t &capacity)
+{
+    int fd = open(tracePath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    size_t mapSize = GetMapSize_(capacity);
+    if (ftruncate(fd, mapSize) < 0) {
+        close(fd);
+        return false;
+    }
+    void* addr = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+
+    header_ = static_cast<TraceHeader*>(addr);
+    records_ = reinterpret_cast<TraceRecord*>(static_cast<char*>(addr) + TRACE_HEADER_SIZE);
+    mapSize_ = mapSize;
+    // Keep the history of the previous run if the layout matches, it is what a crash report needs.
+    if (memcmp(header_->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 || header_->version != TRACE_VERSION || 
+        header_->recordSize != sizeof(TraceRecord) || header_->capacity != capacity) {
+        memset(addr, 0, mapSize);
+        header_->version = TRACE_VERSION;
+        header_->recordSize = sizeof(TraceRecord);
+        header_->capacity = capacity;
+        header_->writePos.store(0, std::memory_order_relaxed);
+        memcpy(header_->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    }
+
+    return true;
+}
+
+void FlightRecorder::Record(const uint64_t &passId, const int &pid, const int &uid, const int &oomAdj, const int &taskType, 
+    const int &decision, const int &signal)
+{
+    if (header_ == nullptr) {
+        return;
+    }
+
+    uint64_t pos = header_->writePos.fetch_add(1, std::memory_order_relaxed);
+    TraceRecord* record = &records_[pos % header_->capacity];
+    struct timespec ts{};
+    clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+    record->timestampMs = (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+    record->passId = (uint32_t)passId;
+    record->pid = pid;
+    record->uid = uid;
+    record->oomAdj = (int16_t)oomAdj;
+    record->taskType = (int8_t)taskType;
+    record->decision = (uint8_t)decision;
+    record->signal = (uint8_t)signal;
+    __atomic_store_n(&record->seq, (uint32_t)(pos + 1), __ATOMIC_RELEASE);
+}
+
+bool FlightRecorder::Dump(const std::string &tracePath, FILE* fp)
+{
+    int fd = open(tracePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) < 0 || (size_t)fileStat.st_size < TRACE_HEADER_SIZE) {
+        close(fd);
+        return false;
+    }
+    void* addr = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+
+    bool ret = false;
+    const auto header = static_cast<const TraceHeader*>(addr);
+    const auto records = reinterpret_cast<const TraceRecord*>(static_cast<const char*>(addr) + TRACE_HEADER_SIZE);
+    if (memcmp(header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) == 0 && header->version == TRACE_VERSION && 
+        header->recordSize == sizeof(TraceRecord) && header->capacity > 0 && 
+        GetMapSize_(header->capacity) <= (size_t)fileStat.st_size) {
+        uint64_t writePos = header->writePos.load(std::memory_order_acquire);
+        uint64_t startPos = writePos > header->capacity ? writePos - header->capacity : 0;
+        for (uint64_t pos = startPos; pos < writePos; pos++) {
+            const TraceRecord &record = records[pos % header->capacity];
+            if (record.seq != (uint32_t)(pos + 1)) {
+                continue;
+            }
+            time_t seconds = record.timestampMs / 1000;
+            struct tm time{};
+            localtime_r(&seconds, &time);
+            char oomAdj[8] = "?";
+            if (record.oomAdj != TRACE_OOM_ADJ_UNKNOWN) {
+                snprintf(oomAdj, sizeof(oomAdj), "%d", record.oomAdj);
+            }
+            fprintf(fp, "%02d-%02d %02d:%02d:%02d.%03d pass=%u pid=%d uid=%d oom_adj=%s type=%s decision=%s signal=%d\n", 
+                time.tm_mon + 1, time.tm_mday, time.tm_hour, time.tm_min, time.tm_sec, (int)(record.timestampMs % 1000), 
+                record.passId, record.pid, record.uid, oomAdj, GetTaskTypeName_(record.taskType), 
+                GetDecisionName_(record.decision), record.signal);
+        }
+        ret = true;
+    }
+    munmap(addr, fileStat.st_size);
+
+    return ret;
+}
+
+size_t FlightRecorder::GetMapSize_(const size_t &capacity)
+{
+    return TRACE_HEADER_SIZE + capacity * sizeof(TraceRecord);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <sys/mman.h>
+#include "utils/cu_misc.h"
+
+#define TRACE_DECISION_NONE 0
+#define TRACE_DECISION_KILL 1
+#define TRACE_DECISION_FREEZE 2
+#define TRACE_DECISION_GRACE 3
+#define TRACE_DECISION_KEEP 4
+#define TRACE_DECISION_THAW 5
+
+#define TRACE_OOM_ADJ_UNKNOWN INT16_MIN
+
+typedef struct {
+    uint64_t timestampMs;
+    uint32_t seq;
+    // Low 32 bits of the controller pass counter (wraps after 2^32 passes), 0 for decisions made outside a pass.
+    uint32_t passId;
+    int32_t pid;
+    int32_t uid;
+    int16_t oomAdj;
+    int8_t taskType;
+    uint8_t decision;
+    uint8_t signal;
+    uint8_t reserved[3];
+} TraceRecord;
+
+// Fixed-size ring of controller decisions in a MAP_SHARED file mapping.
+// A record is a fetch_add and a 32-byte store into the page cache, so the hot path never does a syscall,
+// and whatever was recorded survives a crash of the daemon. Each record stores its sequence number last,
+// which lets the decoder skip slots that were torn by a crash mid-write.
+class FlightRecorder
+{
+    public:
+        static constexpr size_t DEFAULT_CAPACITY = 16384;
+
+        FlightRecorder();
+        ~FlightRecorder();
+        bool Open(const std::string &tracePath, const size_t &capacity = DEFAULT_CAPACITY);
+        void Record(const uint64_t &passId, const int &pid, const int &uid, const int &oomAdj, const int &taskType, 
+            const int &decision, const int &signal);
+        static bool Dump(const std::string &tracePath, FILE* fp);
+
+    private:
+        typedef struct {
+            char magic[8];
+            uint32_t version;
+            uint32_t recordSize;
+            uint64_t capacity;
+            std::atomic<uint64_t> writePos;
+        } TraceHeader;
+
+        TraceHeader* header_;
+        TraceRecord* records_;
+        size_t mapSize_;
+
+        static size_t GetMapSize_(const size_t &capacity);
+};
@@ -0,0 +1,244 @@
+#include "freezer.h"
+
+constexpr char CGROUP_V2_PATH[] = "/sys/fs/cgroup";
+constexpr char FREEZER_V1_GROUP[] = "CuBackgroundCtrl";
+
+Freezer::Freezer() : backend_(FREEZER_SIGNAL), cgroupPath_(), v1RootPath_(), uidFrozen_(), stoppedPids_(), taskWatcher_(nullptr) { }
+
+Freezer::~Freezer() { }
+
+void Freezer::Init(TaskWatcher* taskWatcher)
+{
+    taskWatcher_ = taskWatcher;
+    backend_ = FREEZER_SIGNAL;
+    cgroupPath_ = "";
+    v1RootPath_ = "";
+
+    // Android 12+ places every app process in /sys/fs/cgroup/uid_<uid>/pid_<pid>.
+    if (IsPathExist(StrMerge("%s/uid_1000/cgroup.freeze", CGROUP_V2_PATH))) {
+        backend_ = FREEZER_CGROUP_V2;
+        cgroupPath_ = CGROUP_V2_PATH;
+        return;
+    }
+
+    const auto &mountPath = FindFreezerV1Mount_();
+    if (!mountPath.empty()) {
+        const auto &groupPath = StrMerge("%s/%s", mountPath.c_str(), FREEZER_V1_GROUP);
+        mkdir(groupPath.c_str(), 0755);
+        if (IsPathExist(groupPath + "/freezer.state")) {
+            backend_ = FREEZER_CGROUP_V1;
+            cgroupPath_ = groupPath;
+            v1RootPath_ = mountPath;
+        }
+    }
+}
+
+int Freezer::GetBackend() const
+{
+    return backend_;
+}
+
+void Freezer::FreezeApp(const int &uid, const std::vector<int> &pids, const SignalCallback &callback)
+{
+    if (pids.empty()) {
+        return;
+    }
+    if (backend_ == FREEZER_CGROUP_V2) {
+        if (IsUidOwnedBy_(uid, pids) && 
+            WriteCgroupFile_(StrMerge("%s/uid_%d/cgroup.freeze", cgroupPath_.c_str(), uid), "1")) {
+            uidFrozen_.emplace(uid);
+            for (const int &pid : pids) {
+                Report_(callback, pid, 0);
+            }
+            return;
+        }
+        for (const int &pid : pids) {
+            int sig = 0;
+            if (!WriteCgroupFile_(StrMerge("%s/uid_%d/pid_%d/cgroup.freeze", cgroupPath_.c_str(), uid, pid), "1")) {
+                sig = SendSignal_(pid, SIGSTOP);
+            }
+            Report_(callback, pid, sig);
+        }
+    } else if (backend_ == FREEZER_CGROUP_V1) {
+        const auto &groupPath = StrMerge("%s/uid_%d", cgroupPath_.c_str(), uid);
+        mkdir(groupPath.c_str(), 0755);
+        for (const int &pid : pids) {
+            int sig = 0;
+            if (!WriteCgroupFile_(groupPath + "/cgroup.procs", StrMerge("%d", pid))) {
+                sig = SendSignal_(pid, SIGSTOP);
+            }
+            Report_(callback, pid, sig);
+        }
+        WriteCgroupFile_(groupPath + "/freezer.state", "FROZEN");
+    } else {
+        for (const int &pid : pids) {
+            Report_(callback, pid, SendSignal_(pid, SIGSTOP));
+        }
+    }
+}
+
+void Freezer::ThawApp(const int &uid, const std::vector<int> &pids, const SignalCallback &callback)
+{
+    std::vector<int> sigs(pids.size(), 0);
+    if (backend_ == FREEZER_CGROUP_V2) {
+        if (uidFrozen_.count(uid) == 1) {
+            WriteCgroupFile_(StrMerge("%s/uid_%d/cgroup.freeze", cgroupPath_.c_str(), uid), "0");
+            uidFrozen_.erase(uid);
+        } else {
+            for (size_t idx = 0; idx < pids.size(); idx++) {
+                const int &pid = pids[idx];
+                if (!WriteCgroupFile_(StrMerge("%s/uid_%d/pid_%d/cgroup.freeze", cgroupPath_.c_str(), uid, pid), "0")) {
+                    sigs[idx] = SendSignal_(pid, SIGCONT);
+                }
+            }
+        }
+    } else if (backend_ == FREEZER_CGROUP_V1) {
+        // Tasks are moved back to the root group, which thaws them, so a later FROZEN write to the uid group
+        // doesn't catch tasks that went back to the foreground or belong to another package of the uid.
+        const auto &groupPath = StrMerge("%s/uid_%d", cgroupPath_.c_str(), uid);
+        bool moved = true;
+        for (size_t idx = 0; idx < pids.size(); idx++) {
+            const int &pid = pids[idx];
+            if (!WriteCgroupFile_(v1RootPath_ + "/cgroup.procs", StrMerge("%d", pid))) {
+                // Exited, or stopped by the SIGSTOP fallback in FreezeApp().
+                sigs[idx] = SendSignal_(pid, SIGCONT);
+                if (kill(pid, 0) == 0) {
+                    moved = false;
+                }
+            }
+        }
+        // The group stays frozen while other packages of the uid are parked in it.
+        if (!moved || ReadFile(groupPath + "/cgroup.procs").empty()) {
+            WriteCgroupFile_(groupPath + "/freezer.state", "THAWED");
+        }
+    } else {
+        for (size_t idx = 0; idx < pids.size(); idx++) {
+            sigs[idx] = SendSignal_(pids[idx], SIGCONT);
+        }
+    }
+    for (size_t idx = 0; idx < pids.size(); idx++) {
+        const int &pid = pids[idx];
+        if (stoppedPids_.count(pid) == 1) {
+            sigs[idx] = SendSignal_(pid, SIGCONT);
+            stoppedPids_.erase(pid);
+        }
+        Report_(callback, pid, sigs[idx]);
+    }
+}
+
+void Freezer::StopApp(const std::vector<int> &pids, const SignalCallback &callback)
+{
+    for (const int &pid : pids) {
+        Report_(callback, pid, SendSignal_(pid, SIGSTOP));
+    }
+}
+
+bool Freezer::IsAppFrozen(const int &uid, const std::vector<int> &pids) const
+{
+    bool frozen = true;
+    if (backend_ == FREEZER_CGROUP_V2) {
+        // cgroup.events reports "frozen 1" once every task of the cgroup has actually stopped.
+        if (uidFrozen_.count(uid) == 1) {
+            frozen = StrContains(ReadFile(StrMerge("%s/uid_%d/cgroup.events", cgroupPath_.c_str(), uid)), "frozen 1");
+        } else {
+            for (const int &pid : pids) {
+                const auto &events = ReadFile(StrMerge("%s/uid_%d/pid_%d/cgroup.events", cgroupPath_.c_str(), uid, pid));
+                if (!events.empty() && !StrContains(events, "frozen 1")) {
+                    frozen = false;
+                    break;
+                }
+            }
+        }
+    } else if (backend_ == FREEZER_CGROUP_V1) {
+        frozen = StrContains(ReadFile(StrMerge("%s/uid_%d/freezer.state", cgroupPath_.c_str(), uid)), "FROZEN");
+    }
+
+    return frozen;
+}
+
+bool Freezer::IsUidOwnedBy_(const int &uid, const std::vector<int> &pids) const
+{
+    // The uid cgroup may only be frozen as a whole if it holds nothing but this app's processes.
+    bool owned = false;
+
+    DIR* dir = opendir(StrMerge("%s/uid_%d", cgroupPath_.c_str(), uid).c_str());
+    if (dir) {
+        owned = true;
+        struct dirent* entry = nullptr;
+        while ((entry = readdir(dir)) != nullptr) {
+            if (strncmp(entry->d_name, "pid_", 4) == 0) {
+                int pid = atoi(entry->d_name + 4);
+                if (std::find(pids.begin(), pids.end(), pid) == pids.end()) {
+                    owned = false;
+                    break;
+                }
+            }
+        }
+        closedir(dir);
+    }
+
+    return owned;
+}
+
+void Freezer::ForgetTask(const int &pid)
+{
+    stoppedPids_.erase(pid);
+}
+
+int Freezer::SendSignal_(const int &pid, const int &sig)
+{
+    int ret = -1;
+    if (taskWatcher_ != nullptr) {
+        ret = taskWatcher_->SendSignal(pid, sig);
+    } else {
+        ret = kill(pid, sig);
+    }
+    if (ret != 0) {
+        return 0;
+    }
+    if (sig == SIGSTOP) {
+        stoppedPids_.emplace(pid);
+    } else if (sig == SIGCONT) {
+        stoppedPids_.erase(pid);
+    }
+
+    return sig;
+}
+
+void Freezer::Report_(const SignalCallback &callback, const int &pid, const int &sig)
+{
+    if (callback) {
+        callback(pid, sig);
+    }
+}
+
+std::string Freezer::FindFreezerV1Mount_()
+{
+    std::string mountPath = "";
+
+    FileReader reader{};
+    reader.ForEachLine("/proc/mounts", [&mountPath](const std::string_view &lineView) {
+        // "<device> <mountPath> cgroup <options> 0 0"
+        const std::string line(lineView);
+        if (mountPath.empty() && StrDivide(line, 2) == "cgroup" && StrContains(StrDivide(line, 3), "freezer")) {
+            mountPath = StrDivide(line, 1);
+        }
+    });
+
+    return mountPath;
+}
+
+bool Freezer::WriteCgroupFile_(const std::string &filePath, const std::string &str)
+{
+    bool written = false;
+
+    int fd = open(filePath.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd >= 0) {
+        if (write(fd, str.data(), str.size()) == (ssize_t)str.size()) {
+            written = true;
+        }
+        close(fd);
+    }
+
+    return written;
+}
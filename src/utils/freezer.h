@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <functional>
+#include <csignal>
+#include "utils/cu_misc.h"
+#include "utils/task_watcher.h"
+#include "utils/file_reader.h"
+
+#define FREEZER_SIGNAL 0
+#define FREEZER_CGROUP_V1 1
+#define FREEZER_CGROUP_V2 2
+
+// Freezes and thaws the processes of one app.
+// Prefers the kernel cgroup freezer, where a whole app is frozen with a single write,
+// and falls back to SIGSTOP/SIGCONT when no usable freezer hierarchy is found.
+class Freezer
+{
+    public:
+        // Called for every pid an operation touched, with the signal that was sent to it or 0.
+        using SignalCallback = std::function<void(int, int)>;
+
+        Freezer();
+        ~Freezer();
+        void Init(TaskWatcher* taskWatcher);
+        int GetBackend() const;
+        void FreezeApp(const int &uid, const std::vector<int> &pids, const SignalCallback &callback = nullptr);
+        void ThawApp(const int &uid, const std::vector<int> &pids, const SignalCallback &callback = nullptr);
+        // SIGSTOPs the tasks whatever the backend, for apps the cgroup freezer failed to freeze.
+        void StopApp(const std::vector<int> &pids, const SignalCallback &callback = nullptr);
+        // Returns false while the cgroup freezer has not stopped every task yet.
+        bool IsAppFrozen(const int &uid, const std::vector<int> &pids) const;
+        void ForgetTask(const int &pid);
+
+    private:
+        int backend_;
+        std::string cgroupPath_;
+        std::string v1RootPath_;
+        std::unordered_set<int> uidFrozen_;
+        // Tasks stopped with SIGSTOP, ThawApp() sends them SIGCONT whatever the backend did for the rest.
+        std::unordered_set<int> stoppedPids_;
+        TaskWatcher* taskWatcher_;
+
+        bool IsUidOwnedBy_(const int &uid, const std::vector<int> &pids) const;
+        int SendSignal_(const int &pid, const int &sig);
+        static void Report_(const SignalCallback &callback, const int &pid, const int &sig);
+        static std::string FindFreezerV1Mount_();
+        static bool WriteCgroupFile_(const std::string &filePath, const std::string &str);
+};
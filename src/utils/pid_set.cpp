@@ -0,0 +1,80 @@
+#include "pid_set.h"
+
+PidSet::PidSet() : leaves_(LEAF_NUM), summary_(), size_(0) { }
+
+PidSet::~PidSet() { }
+
+bool PidSet::Insert(const int &pid)
+{
+    if (pid <= 0 || pid >= PID_LIMIT) {
+        return false;
+    }
+
+    int leafIdx = pid / LEAF_BITS;
+    auto &leaf = leaves_[leafIdx];
+    if (!leaf) {
+        leaf.reset(new Leaf());
+    }
+    uint64_t mask = 1ULL << (pid % 64);
+    uint64_t &word = leaf->words[(pid % LEAF_BITS) / 64];
+    if ((word & mask) != 0) {
+        return false;
+    }
+    word |= mask;
+    leaf->count++;
+    summary_[leafIdx / 64] |= 1ULL << (leafIdx % 64);
+    size_++;
+
+    return true;
+}
+
+bool PidSet::Erase(const int &pid)
+{
+    if (!Contains(pid)) {
+        return false;
+    }
+
+    int leafIdx = pid / LEAF_BITS;
+    auto &leaf = leaves_[leafIdx];
+    leaf->words[(pid % LEAF_BITS) / 64] &= ~(1ULL << (pid % 64));
+    leaf->count--;
+    if (leaf->count == 0) {
+        summary_[leafIdx / 64] &= ~(1ULL << (leafIdx % 64));
+    }
+    size_--;
+
+    return true;
+}
+
+bool PidSet::Contains(const int &pid) const
+{
+    if (pid <= 0 || pid >= PID_LIMIT) {
+        return false;
+    }
+
+    int leafIdx = pid / LEAF_BITS;
+    if ((summary_[leafIdx / 64] & (1ULL << (leafIdx % 64))) == 0) {
+        return false;
+    }
+
+    return (leaves_[leafIdx]->words[(pid % LEAF_BITS) / 64] & (1ULL << (pid % 64))) != 0;
+}
+
+void PidSet::Clear()
+{
+    for (int summaryIdx = 0; summaryIdx < SUMMARY_WORDS; summaryIdx++) {
+        uint64_t summaryBits = summary_[summaryIdx];
+        while (summaryBits != 0) {
+            int leafIdx = summaryIdx * 64 + __builtin_ctzll(summaryBits);
+            summaryBits &= summaryBits - 1;
+            memset(leaves_[leafIdx].get(), 0, sizeof(Leaf));
+        }
+        summary_[summaryIdx] = 0;
+    }
+    size_ = 0;
+}
+
+size_t PidSet::GetSize() const
+{
+    return size_;
+}
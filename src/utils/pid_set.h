@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+
+// Two-level bitmap covering the whole pid space (PID_MAX_LIMIT on 64-bit kernels).
+// Leaves of 4096 pids are allocated on first use and a summary bitmap tracks the non-empty ones,
+// so membership is a bit test and set differences run 64 pids per word.
+class PidSet
+{
+    public:
+        static constexpr int PID_LIMIT = 4194304;
+
+        PidSet();
+        ~PidSet();
+        PidSet(PidSet &&other) = default;
+        PidSet &operator=(PidSet &&other) = default;
+        bool Insert(const int &pid);
+        bool Erase(const int &pid);
+        bool Contains(const int &pid) const;
+        void Clear();
+        size_t GetSize() const;
+
+        template <typename Func>
+        void ForEach(const Func &func) const
+        {
+            ForEachDifference_(nullptr, func);
+        }
+
+        // Calls func for every pid of this set that is not in other.
+        template <typename Func>
+        void ForEachDifference(const PidSet &other, const Func &func) const
+        {
+            ForEachDifference_(&other, func);
+        }
+
+    private:
+        static constexpr int LEAF_BITS = 4096;
+        static constexpr int LEAF_WORDS = LEAF_BITS / 64;
+        static constexpr int LEAF_NUM = PID_LIMIT / LEAF_BITS;
+        static constexpr int SUMMARY_WORDS = LEAF_NUM / 64;
+
+        typedef struct {
+            uint64_t words[LEAF_WORDS];
+            uint32_t count;
+        } Leaf;
+
+        std::vector<std::unique_ptr<Leaf>> leaves_;
+        uint64_t summary_[SUMMARY_WORDS];
+        size_t size_;
+
+        template <typename Func>
+        void ForEachDifference_(const PidSet* other, const Func &func) const
+        {
+            for (int summaryIdx = 0; summaryIdx < SUMMARY_WORDS; summaryIdx++) {
+                uint64_t summaryBits = summary_[summaryIdx];
+                while (summaryBits != 0) {
+                    int leafIdx = summaryIdx * 64 + __builtin_ctzll(summaryBits);
+                    summaryBits &= summaryBits - 1;
+                    const Leaf* leaf = leaves_[leafIdx].get();
+                    const Leaf* otherLeaf = nullptr;
+                    if (other != nullptr && (other->summary_[summaryIdx] & (1ULL << (leafIdx % 64))) != 0) {
+                        otherLeaf = other->leaves_[leafIdx].get();
+                    }
+                    for (int wordIdx = 0; wordIdx < LEAF_WORDS; wordIdx++) {
+                        uint64_t bits = leaf->words[wordIdx];
+                        if (otherLeaf != nullptr) {
+                            bits &= ~otherLeaf->words[wordIdx];
+                        }
+                        while (bits != 0) {
+                            func(leafIdx * LEAF_BITS + wordIdx * 64 + __builtin_ctzll(bits));
+                            bits &= bits - 1;
+                        }
+                    }
+                }
+            }
+        }
+};
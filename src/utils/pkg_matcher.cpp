@@ -0,0 +1,244 @@
+#include "pkg_matcher.h"
+#include "utils/pkg_name.h"
+
+PkgMatcher::PkgMatcher() : exactRules_(), exactMap_(), wildcardRules_(), trie_(1, TrieNode{}) { }
+
+PkgMatcher::~PkgMatcher() { }
+
+PkgMatcher::PkgMatcher(const PkgMatcher &other) : 
+    exactRules_(other.exactRules_), 
+    exactMap_(), 
+    wildcardRules_(other.wildcardRules_), 
+    trie_(other.trie_) 
+{
+    RebuildExactMap_();
+}
+
+PkgMatcher &PkgMatcher::operator=(const PkgMatcher &other)
+{
+    if (this != &other) {
+        exactRules_ = other.exactRules_;
+        wildcardRules_ = other.wildcardRules_;
+        trie_ = other.trie_;
+        RebuildExactMap_();
+    }
+
+    return *this;
+}
+
+bool PkgMatcher::AddRule(const std::string &rule, const int &value)
+{
+    bool added = false;
+
+    // Adding a rule that already exists replaces its value.
+    const auto &pkgNameInfo = ParsePkgName(rule);
+    if (pkgNameInfo.type == PKG_NAME_APP) {
+        const auto &iter = exactRules_.insert_or_assign(rule.substr(0, pkgNameInfo.pkgNameLen), value);
+        exactMap_[std::string_view(iter.first->first)] = value;
+        added = true;
+    } else {
+        std::string_view prefix(rule);
+        while (!prefix.empty() && (prefix.back() == ' ' || prefix.back() == '\t' || prefix.back() == '\r')) {
+            prefix.remove_suffix(1);
+        }
+        if (prefix.size() > 2 && prefix.substr(prefix.size() - 2) == ".*") {
+            prefix.remove_suffix(1);
+            if (IsRulePrefix_(prefix)) {
+                AddWildcard_(prefix, value);
+                std::string wildcardRule = std::string(prefix) + "*";
+                const auto &iter = std::find_if(wildcardRules_.begin(), wildcardRules_.end(), 
+                    [&wildcardRule](const std::pair<std::string, int> &item) { return item.first == wildcardRule; });
+                if (iter != wildcardRules_.end()) {
+                    iter->second = value;
+                } else {
+                    wildcardRules_.emplace_back(wildcardRule, value);
+                }
+                added = true;
+            }
+        }
+    }
+
+    return added;
+}
+
+bool PkgMatcher::RemoveRule(const std::string &rule)
+{
+    bool removed = false;
+    const auto &exactIter = exactRules_.find(rule);
+    if (exactIter != exactRules_.end()) {
+        exactMap_.erase(std::string_view(exactIter->first));
+        exactRules_.erase(exactIter);
+        removed = true;
+    } else {
+        const auto &iter = std::find_if(wildcardRules_.begin(), wildcardRules_.end(), 
+            [&rule](const std::pair<std::string, int> &item) { return item.first == rule; });
+        if (iter != wildcardRules_.end()) {
+            // Wildcards share trie nodes, rebuilding the trie is simpler than pruning it and rules change rarely.
+            wildcardRules_.erase(iter);
+            trie_.assign(1, TrieNode{});
+            for (const auto &[wildcardRule, value] : wildcardRules_) {
+                AddWildcard_(std::string_view(wildcardRule.data(), wildcardRule.size() - 1), value);
+            }
+            removed = true;
+        }
+    }
+
+    return removed;
+}
+
+void PkgMatcher::Clear()
+{
+    exactMap_.clear();
+    exactRules_.clear();
+    wildcardRules_.clear();
+    trie_.assign(1, TrieNode{});
+}
+
+bool PkgMatcher::Match(const std::string_view &pkgName) const
+{
+    if (exactMap_.count(pkgName) == 1) {
+        return true;
+    }
+
+    bool matched = false;
+    if (!wildcardRules_.empty()) {
+        int32_t node = 0;
+        for (size_t pos = 0; pos < pkgName.size(); pos++) {
+            if (trie_[node].wildcard) {
+                matched = true;
+                break;
+            }
+            int idx = GetCharIndex_(pkgName[pos]);
+            if (idx < 0 || trie_[node].child[idx] == 0) {
+                break;
+            }
+            node = trie_[node].child[idx];
+        }
+    }
+
+    return matched;
+}
+
+bool PkgMatcher::GetRule(const std::string &rule, int* value) const
+{
+    // Looks the rule itself up, not the packages it matches.
+    const auto &exactIter = exactRules_.find(rule);
+    if (exactIter != exactRules_.end()) {
+        *value = exactIter->second;
+        return true;
+    }
+    const auto &iter = std::find_if(wildcardRules_.begin(), wildcardRules_.end(), 
+        [&rule](const std::pair<std::string, int> &item) { return item.first == rule; });
+    if (iter != wildcardRules_.end()) {
+        *value = iter->second;
+        return true;
+    }
+
+    return false;
+}
+
+bool PkgMatcher::Find(const std::string_view &pkgName, int* value) const
+{
+    const auto &iter = exactMap_.find(pkgName);
+    if (iter != exactMap_.end()) {
+        *value = iter->second;
+        return true;
+    }
+
+    // Unlike Match(), keep walking past the first wildcard so the longest prefix decides.
+    bool matched = false;
+    if (!wildcardRules_.empty()) {
+        int32_t node = 0;
+        for (size_t pos = 0; pos < pkgName.size(); pos++) {
+            if (trie_[node].wildcard) {
+                *value = trie_[node].value;
+                matched = true;
+            }
+            int idx = GetCharIndex_(pkgName[pos]);
+            if (idx < 0 || trie_[node].child[idx] == 0) {
+                break;
+            }
+            node = trie_[node].child[idx];
+        }
+    }
+
+    return matched;
+}
+
+size_t PkgMatcher::GetRuleCount() const
+{
+    return exactRules_.size() + wildcardRules_.size();
+}
+
+std::vector<std::pair<std::string, int>> PkgMatcher::GetRules() const
+{
+    std::vector<std::pair<std::string, int>> rules(exactRules_.begin(), exactRules_.end());
+    std::sort(rules.begin(), rules.end());
+    rules.insert(rules.end(), wildcardRules_.begin(), wildcardRules_.end());
+
+    return rules;
+}
+
+int PkgMatcher::GetCharIndex_(const char &c)
+{
+    int idx = -1;
+    if (c >= 'a' && c <= 'z') {
+        idx = c - 'a';
+    } else if (c >= 'A' && c <= 'Z') {
+        idx = c - 'A' + 26;
+    } else if (c >= '0' && c <= '9') {
+        idx = c - '0' + 52;
+    } else if (c == '_') {
+        idx = 62;
+    } else if (c == '.') {
+        idx = 63;
+    }
+
+    return idx;
+}
+
+bool PkgMatcher::IsRulePrefix_(const std::string_view &prefix)
+{
+    // "<segment>(.<segment>)*." where every segment is made of word characters.
+    bool valid = true;
+    size_t segmentLen = 0;
+    for (const char &c : prefix) {
+        if (c == '.') {
+            if (segmentLen == 0) {
+                valid = false;
+                break;
+            }
+            segmentLen = 0;
+        } else if (GetCharIndex_(c) >= 0) {
+            segmentLen++;
+        } else {
+            valid = false;
+            break;
+        }
+    }
+
+    return valid;
+}
+
+void PkgMatcher::AddWildcard_(const std::string_view &prefix, const int &value)
+{
+    int32_t node = 0;
+    for (const char &c : prefix) {
+        int idx = GetCharIndex_(c);
+        if (trie_[node].child[idx] == 0) {
+            trie_[node].child[idx] = (int32_t)trie_.size();
+            trie_.emplace_back(TrieNode{});
+        }
+        node = trie_[node].child[idx];
+    }
+    trie_[node].wildcard = true;
+    trie_[node].value = value;
+}
+
+void PkgMatcher::RebuildExactMap_()
+{
+    exactMap_.clear();
+    for (const auto &[rule, value] : exactRules_) {
+        exactMap_.emplace(std::string_view(rule), value);
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+
+// Maps package names to the value of the rule they match, from a rule list built once per config load.
+// "com.foo.bar" is an exact rule, looked up in a hash map;
+// "com.google.*" matches every package below "com.google." and is resolved by a character trie.
+// An exact rule wins over wildcards, and the longest wildcard wins over shorter ones.
+class PkgMatcher
+{
+    public:
+        PkgMatcher();
+        ~PkgMatcher();
+        PkgMatcher(const PkgMatcher &other);
+        PkgMatcher &operator=(const PkgMatcher &other);
+        bool AddRule(const std::string &rule, const int &value = 0);
+        bool RemoveRule(const std::string &rule);
+        void Clear();
+        bool Match(const std::string_view &pkgName) const;
+        bool Find(const std::string_view &pkgName, int* value) const;
+        bool GetRule(const std::string &rule, int* value) const;
+        size_t GetRuleCount() const;
+        std::vector<std::pair<std::string, int>> GetRules() const;
+
+    private:
+        static constexpr int CHILD_NUM = 64;
+
+        typedef struct {
+            int32_t child[CHILD_NUM];
+            bool wildcard;
+            int value;
+        } TrieNode;
+
+        std::unordered_map<std::string, int> exactRules_;
+        std::unordered_map<std::string_view, int> exactMap_;
+        std::vector<std::pair<std::string, int>> wildcardRules_;
+        std::vector<TrieNode> trie_;
+
+        static int GetCharIndex_(const char &c);
+        static bool IsRulePrefix_(const std::string_view &prefix);
+        void AddWildcard_(const std::string_view &prefix, const int &value);
+        void RebuildExactMap_();
+};
@@ -0,0 +1,70 @@
+#include "pkg_name.h"
+
+// Hand-written equivalent of std::regex_search(str, std::regex("^[\\w]+([.][\\w]+)+[\\s]*$")),
+// which additionally recognizes "<pkgName>:<process>" as a subprocess of <pkgName>.
+
+static inline bool IsWordChar_(const char &c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+static inline bool IsSpaceChar_(const char &c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+PkgNameInfo ParsePkgName(const char* str, const size_t &len)
+{
+    PkgNameInfo info{};
+    info.type = PKG_NAME_INVALID;
+    info.pkgNameLen = 0;
+
+    size_t pos = 0;
+    int segmentNum = 0;
+    for (;;) {
+        size_t segmentStart = pos;
+        while (pos < len && IsWordChar_(str[pos])) {
+            pos++;
+        }
+        if (pos == segmentStart) {
+            return info;
+        }
+        segmentNum++;
+        if (pos < len && str[pos] == '.') {
+            pos++;
+        } else {
+            break;
+        }
+    }
+    if (segmentNum < 2) {
+        return info;
+    }
+
+    size_t pkgNameLen = pos;
+    if (pos < len && str[pos] == ':') {
+        if (pos + 1 < len) {
+            info.type = PKG_NAME_SUBPROCESS;
+            info.pkgNameLen = pkgNameLen;
+        }
+        return info;
+    }
+    while (pos < len && IsSpaceChar_(str[pos])) {
+        pos++;
+    }
+    if (pos == len) {
+        info.type = PKG_NAME_APP;
+        info.pkgNameLen = pkgNameLen;
+    }
+
+    return info;
+}
+
+PkgNameInfo ParsePkgName(const std::string &str)
+{
+    return ParsePkgName(str.data(), str.size());
+}
+
+bool IsPkgName(const std::string &str)
+{
+    return ParsePkgName(str.data(), str.size()).type == PKG_NAME_APP;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+#define PKG_NAME_INVALID 0
+#define PKG_NAME_APP 1
+#define PKG_NAME_SUBPROCESS 2
+
+typedef struct {
+    int type;
+    size_t pkgNameLen;
+} PkgNameInfo;
+
+PkgNameInfo ParsePkgName(const char* str, const size_t &len);
+PkgNameInfo ParsePkgName(const std::string &str);
+bool IsPkgName(const std::string &str);
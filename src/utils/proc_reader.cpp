@@ -0,0 +1,115 @@
+#include "proc_reader.h"
+
+constexpr int OOM_SCORE_ADJ_MAX = 1000;
+constexpr int OOM_ADJUST_MAX = 15;
+constexpr int OOM_DISABLE = -17;
+
+static thread_local char procBuffer[4096];
+
+ProcReader::ProcReader() : ProcReader("/proc") { }
+
+ProcReader::ProcReader(const std::string &procPath) : 
+    procFd_(open(procPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)) { }
+
+ProcReader::~ProcReader()
+{
+    if (procFd_ >= 0) {
+        close(procFd_);
+    }
+}
+
+bool ProcReader::ReadTask(const int &pid, const int &fields, ProcTaskInfo* info) const
+{
+    char path[32] = { 0 };
+
+    if (fields & PROC_READ_STAT) {
+        snprintf(path, sizeof(path), "%d/stat", pid);
+        if (ReadAt_(path, procBuffer, sizeof(procBuffer)) <= 0 || !ParseStat_(procBuffer, info)) {
+            return false;
+        }
+    }
+    if (fields & PROC_READ_OOM) {
+        // oom_adj is derived from oom_score_adj the same way the kernel's oom_adj file does it.
+        snprintf(path, sizeof(path), "%d/oom_score_adj", pid);
+        if (ReadAt_(path, procBuffer, sizeof(procBuffer)) <= 0) {
+            return false;
+        }
+        info->oomScoreAdj = (int)strtol(procBuffer, nullptr, 10);
+        if (info->oomScoreAdj == OOM_SCORE_ADJ_MAX) {
+            info->oomAdj = OOM_ADJUST_MAX;
+        } else {
+            info->oomAdj = (info->oomScoreAdj * -OOM_DISABLE) / OOM_SCORE_ADJ_MAX;
+        }
+    }
+    if (fields & PROC_READ_NAME) {
+        snprintf(path, sizeof(path), "%d/cmdline", pid);
+        ssize_t len = ReadAt_(path, procBuffer, sizeof(procBuffer));
+        if (len < 0) {
+            return false;
+        }
+        size_t nameLen = strnlen(procBuffer, (size_t)len);
+        nameLen = std::min(nameLen, sizeof(info->name) - 1);
+        memcpy(info->name, procBuffer, nameLen);
+        info->name[nameLen] = '\0';
+        info->nameLen = nameLen;
+    }
+    if (fields & PROC_READ_UID) {
+        snprintf(path, sizeof(path), "%d", pid);
+        struct stat task_stat{};
+        if (fstatat(procFd_, path, &task_stat, 0) != 0) {
+            return false;
+        }
+        info->uid = (int)task_stat.st_uid;
+    }
+
+    return true;
+}
+
+ssize_t ProcReader::ReadAt_(const char* path, char* buffer, const size_t &size) const
+{
+    ssize_t len = -1;
+
+    int fd = openat(procFd_, path, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        len = read(fd, buffer, size - 1);
+        if (len >= 0) {
+            buffer[len] = '\0';
+        }
+        close(fd);
+    }
+
+    return len;
+}
+
+bool ProcReader::ParseStat_(const char* buffer, ProcTaskInfo* info)
+{
+    // comm may contain spaces and brackets, so fields are counted from the last ')'.
+    const char* ptr = strrchr(buffer, ')');
+    if (ptr == nullptr || ptr[1] != ' ') {
+        return false;
+    }
+    ptr += 2;
+
+    int field = 3;
+    while (*ptr != '\0' && field <= 22) {
+        if (field == 3) {
+            info->state = *ptr;
+        } else if (field == 14) {
+            info->utime = strtoull(ptr, nullptr, 10);
+        } else if (field == 15) {
+            info->stime = strtoull(ptr, nullptr, 10);
+        } else if (field == 22) {
+            info->startTime = strtoull(ptr, nullptr, 10);
+            return true;
+        }
+        while (*ptr != '\0' && *ptr != ' ') {
+            ptr++;
+        }
+        if (*ptr == ' ') {
+            ptr++;
+        }
+        field++;
+    }
+
+    return false;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include "utils/cu_misc.h"
+
+#define PROC_READ_NAME 0x1
+#define PROC_READ_STAT 0x2
+#define PROC_READ_OOM 0x4
+#define PROC_READ_UID 0x8
+
+typedef struct {
+    char name[256];
+    size_t nameLen;
+    char state;
+    uint64_t utime;
+    uint64_t stime;
+    uint64_t startTime;
+    int oomAdj;
+    int oomScoreAdj;
+    int uid;
+} ProcTaskInfo;
+
+// Reads process metadata relative to a /proc dirfd into per-thread buffers.
+// Each requested field group costs one openat/read/close (PROC_READ_UID is a single fstatat),
+// and nothing is allocated on the heap.
+class ProcReader
+{
+    public:
+        ProcReader();
+        ProcReader(const std::string &procPath);
+        ~ProcReader();
+        bool ReadTask(const int &pid, const int &fields, ProcTaskInfo* info) const;
+
+    private:
+        int procFd_;
+
+        ssize_t ReadAt_(const char* path, char* buffer, const size_t &size) const;
+        static bool ParseStat_(const char* buffer, ProcTaskInfo* info);
+};
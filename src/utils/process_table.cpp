@@ -0,0 +1,123 @@
+#include "process_table.h"
+
+constexpr uint64_t FULL_CHECK_PASSES = 64;
+
+ProcessTable::ProcessTable(const ProcReader* procReader) : 
+    procReader_(procReader),
+    taskMap_(), 
+    passId_(0), 
+    eventDriven_(false), 
+    fullCheck_(true), 
+    fullCheckRequested_(false) { }
+
+ProcessTable::~ProcessTable() { }
+
+void ProcessTable::SetEventDriven(const bool &eventDriven)
+{
+    eventDriven_ = eventDriven;
+    fullCheckRequested_ = true;
+}
+
+void ProcessTable::ApplyEvent(const TaskEvent &event)
+{
+    if (event.type == TASK_EVENT_OVERFLOW) {
+        fullCheckRequested_ = true;
+        return;
+    }
+
+    const auto &iter = taskMap_.find(event.pid);
+    if (iter != taskMap_.end()) {
+        if (event.type == TASK_EVENT_EXIT || event.type == TASK_EVENT_FORK) {
+            // A fork of a known pid means its exit was missed.
+            taskMap_.erase(iter);
+        } else {
+            iter->second.stale = true;
+        }
+    }
+}
+
+void ProcessTable::BeginPass()
+{
+    passId_++;
+    fullCheck_ = !eventDriven_ || fullCheckRequested_ || (passId_ % FULL_CHECK_PASSES) == 0;
+    fullCheckRequested_ = false;
+}
+
+void ProcessTable::UpdateTask(const int &pid)
+{
+    if (!fullCheck_) {
+        const auto &iter = taskMap_.find(pid);
+        if (iter != taskMap_.end() && !iter->second.stale && IsTaskNameSettled_(iter->second.taskName)) {
+            iter->second.passId = passId_;
+            return;
+        }
+    }
+
+    ProcTaskInfo procTaskInfo{};
+    if (!procReader_->ReadTask(pid, PROC_READ_STAT, &procTaskInfo)) {
+        return;
+    }
+    uint64_t startTime = procTaskInfo.startTime;
+
+    auto iter = taskMap_.find(pid);
+    if (iter == taskMap_.end()) {
+        TaskInfo taskInfo{};
+        taskInfo.startTime = startTime;
+        if (!ReadTaskName_(pid, &taskInfo)) {
+            return;
+        }
+        taskInfo.passId = passId_;
+        taskMap_.emplace(pid, std::move(taskInfo));
+    } else {
+        auto &taskInfo = iter->second;
+        if (taskInfo.startTime != startTime) {
+            taskInfo.startTime = startTime;
+            ReadTaskName_(pid, &taskInfo);
+        } else if (taskInfo.stale || !IsTaskNameSettled_(taskInfo.taskName)) {
+            ReadTaskName_(pid, &taskInfo);
+        }
+        taskInfo.passId = passId_;
+    }
+}
+
+void ProcessTable::EndPass()
+{
+    for (auto iter = taskMap_.begin(); iter != taskMap_.end();) {
+        if (iter->second.passId != passId_) {
+            iter = taskMap_.erase(iter);
+        } else {
+            iter++;
+        }
+    }
+}
+
+const std::unordered_map<int, ProcessTable::TaskInfo> &ProcessTable::GetTasks() const
+{
+    return taskMap_;
+}
+
+bool ProcessTable::IsTaskNameSettled_(const std::string &taskName)
+{
+    // Processes forked from zygote keep their starttime but rename themselves after specialization.
+    bool settled = true;
+    if (taskName.empty() || taskName[0] == '<' || taskName.compare(0, 6, "zygote") == 0 || 
+        taskName.compare(0, 4, "usap") == 0) {
+        settled = false;
+    }
+
+    return settled;
+}
+
+bool ProcessTable::ReadTaskName_(const int &pid, TaskInfo* taskInfo) const
+{
+    ProcTaskInfo procTaskInfo{};
+    if (!procReader_->ReadTask(pid, PROC_READ_NAME | PROC_READ_UID, &procTaskInfo)) {
+        return false;
+    }
+    taskInfo->taskName.assign(procTaskInfo.name, procTaskInfo.nameLen);
+    taskInfo->pkgNameInfo = ParsePkgName(taskInfo->taskName);
+    taskInfo->uid = procTaskInfo.uid;
+    taskInfo->stale = false;
+
+    return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <unordered_map>
+#include <string>
+#include "utils/cu_misc.h"
+#include "utils/pkg_name.h"
+#include "utils/proc_reader.h"
+
+#define TASK_EVENT_FORK 0
+#define TASK_EVENT_EXEC 1
+#define TASK_EVENT_COMM 2
+#define TASK_EVENT_UID 3
+#define TASK_EVENT_EXIT 4
+#define TASK_EVENT_OVERFLOW 5
+
+typedef struct {
+    int type;
+    int pid;
+} TaskEvent;
+
+// Caches per-process metadata across controller passes.
+// Entries are keyed by (pid, starttime), so a reused pid is treated as a new process.
+// When process events are delivered, known entries are trusted without touching /proc,
+// and starttime is only re-checked on a periodic consistency pass.
+class ProcessTable
+{
+    public:
+        typedef struct {
+            uint64_t startTime;
+            std::string taskName;
+            PkgNameInfo pkgNameInfo;
+            int uid;
+            uint64_t passId;
+            bool stale;
+        } TaskInfo;
+
+        ProcessTable(const ProcReader* procReader);
+        ~ProcessTable();
+        void SetEventDriven(const bool &eventDriven);
+        void ApplyEvent(const TaskEvent &event);
+        void BeginPass();
+        void UpdateTask(const int &pid);
+        void EndPass();
+        const std::unordered_map<int, TaskInfo> &GetTasks() const;
+
+    private:
+        const ProcReader* procReader_;
+        std::unordered_map<int, TaskInfo> taskMap_;
+        uint64_t passId_;
+        bool eventDriven_;
+        bool fullCheck_;
+        bool fullCheckRequested_;
+
+        static bool IsTaskNameSettled_(const std::string &taskName);
+        bool ReadTaskName_(const int &pid, TaskInfo* taskInfo) const;
+};
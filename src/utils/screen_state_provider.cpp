@@ -0,0 +1,330 @@
+#include "screen_state_provider.h"
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+
+constexpr char BACKLIGHT_CLASS_PATH[] = "/sys/class/backlight";
+constexpr char LCD_BACKLIGHT_PATH[] = "/sys/class/leds/lcd-backlight/brightness";
+
+static std::string FindBrightnessPath_(void)
+{
+    std::string brightnessPath = "";
+
+    DIR* dir = opendir(BACKLIGHT_CLASS_PATH);
+    if (dir) {
+        struct dirent* entry = nullptr;
+        while ((entry = readdir(dir)) != nullptr) {
+            if (entry->d_name[0] != '.') {
+                const auto &path = StrMerge("%s/%s/brightness", BACKLIGHT_CLASS_PATH, entry->d_name);
+                if (IsPathExist(path)) {
+                    brightnessPath = path;
+                    break;
+                }
+            }
+        }
+        closedir(dir);
+    }
+    if (brightnessPath.empty() && IsPathExist(LCD_BACKLIGHT_PATH)) {
+        brightnessPath = LCD_BACKLIGHT_PATH;
+    }
+
+    return brightnessPath;
+}
+
+static int ReadIntegerAt_(const int &fd)
+{
+    int value = -1;
+
+    char buffer[32] = { 0 };
+    ssize_t len = pread(fd, buffer, sizeof(buffer) - 1, 0);
+    if (len > 0) {
+        buffer[len] = '\0';
+        value = atoi(buffer);
+    }
+
+    return value;
+}
+
+static void DrainInotify_(const int &fd)
+{
+    char buffer[1024] __attribute__((aligned(__alignof__(struct inotify_event))));
+    while (read(fd, buffer, sizeof(buffer)) > 0) { }
+}
+
+ScreenStateProvider::ScreenStateProvider() : callback_(), state_(SCREEN_ON) { }
+
+ScreenStateProvider::~ScreenStateProvider() { }
+
+int ScreenStateProvider::GetState() const
+{
+    return state_.load(std::memory_order_relaxed);
+}
+
+void ScreenStateProvider::UpdateState_(const int &state)
+{
+    if (state_.exchange(state) != state && callback_) {
+        callback_(state);
+    }
+}
+
+void ScreenStateProvider::SetCallback_(const StateCallback &callback, const int &state)
+{
+    callback_ = callback;
+    state_ = state;
+}
+
+BrightnessScreenStateProvider::BrightnessScreenStateProvider(const int &androidSDKVersion) : 
+    ScreenStateProvider(), 
+    brightnessPath_(), 
+    androidSDKVersion_(androidSDKVersion), 
+    brightnessFd_(-1), 
+    blPowerFd_(-1), 
+    verified_(false), 
+    heuristic_(nullptr) { }
+
+BrightnessScreenStateProvider::~BrightnessScreenStateProvider()
+{
+    if (blPowerFd_ >= 0) {
+        close(blPowerFd_);
+    }
+    if (brightnessFd_ >= 0) {
+        close(brightnessFd_);
+    }
+}
+
+bool BrightnessScreenStateProvider::InitBrightness_(const StateCallback &callback)
+{
+    brightnessPath_ = FindBrightnessPath_();
+    if (brightnessPath_.empty()) {
+        return false;
+    }
+    brightnessFd_ = open(brightnessPath_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (brightnessFd_ < 0) {
+        return false;
+    }
+    // Only the backlight class has bl_power, FB_BLANK_UNBLANK (0) is the only unblanked value.
+    blPowerFd_ = open(StrMerge("%s/bl_power", GetRePrevString(brightnessPath_, '/').c_str()).c_str(), O_RDONLY | O_CLOEXEC);
+
+    int state = ReadState_();
+    if (state == SCREEN_OFF) {
+        verified_ = true;
+    } else {
+        heuristic_.reset(new HeuristicScreenStateProvider(androidSDKVersion_));
+        using namespace std::placeholders;
+        if (heuristic_->Init(std::bind(&BrightnessScreenStateProvider::HeuristicChanged_, this, _1))) {
+            state = heuristic_->GetState();
+        } else {
+            // Nothing to cross-check against, the brightness source is all there is.
+            heuristic_.reset();
+            verified_ = true;
+        }
+    }
+    SetCallback_(callback, state);
+
+    return true;
+}
+
+void BrightnessScreenStateProvider::BrightnessChanged_()
+{
+    int state = ReadState_();
+    if (state == SCREEN_OFF) {
+        verified_ = true;
+    }
+    if (verified_) {
+        UpdateState_(state);
+    }
+}
+
+int BrightnessScreenStateProvider::ReadState_() const
+{
+    int state = SCREEN_ON;
+    if (ReadIntegerAt_(brightnessFd_) == 0 || (blPowerFd_ >= 0 && ReadIntegerAt_(blPowerFd_) > 0)) {
+        state = SCREEN_OFF;
+    }
+
+    return state;
+}
+
+void BrightnessScreenStateProvider::HeuristicChanged_(const int &state)
+{
+    if (!verified_) {
+        UpdateState_(state);
+    }
+}
+
+BacklightScreenStateProvider::BacklightScreenStateProvider(const int &androidSDKVersion) : 
+    BrightnessScreenStateProvider(androidSDKVersion), 
+    inotifyFd_(-1) { }
+
+BacklightScreenStateProvider::~BacklightScreenStateProvider()
+{
+    if (inotifyFd_ >= 0) {
+        Reactor::GetInstance()->RemoveFd(inotifyFd_);
+        close(inotifyFd_);
+    }
+}
+
+bool BacklightScreenStateProvider::Init(const StateCallback &callback)
+{
+    if (!InitBrightness_(callback)) {
+        return false;
+    }
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0) {
+        return false;
+    }
+    if (inotify_add_watch(inotifyFd_, brightnessPath_.c_str(), IN_MODIFY) < 0) {
+        return false;
+    }
+
+    using namespace std::placeholders;
+    return Reactor::GetInstance()->AddFd(inotifyFd_, EPOLLIN, std::bind(&BacklightScreenStateProvider::InotifyReadable_, this, _1));
+}
+
+const char* BacklightScreenStateProvider::GetName() const
+{
+    return "backlight";
+}
+
+void BacklightScreenStateProvider::InotifyReadable_(uint32_t)
+{
+    DrainInotify_(inotifyFd_);
+    BrightnessChanged_();
+}
+
+UeventScreenStateProvider::UeventScreenStateProvider(const int &androidSDKVersion) : 
+    BrightnessScreenStateProvider(androidSDKVersion), 
+    sockFd_(-1) { }
+
+UeventScreenStateProvider::~UeventScreenStateProvider()
+{
+    if (sockFd_ >= 0) {
+        Reactor::GetInstance()->RemoveFd(sockFd_);
+        close(sockFd_);
+    }
+}
+
+bool UeventScreenStateProvider::Init(const StateCallback &callback)
+{
+    if (!InitBrightness_(callback)) {
+        return false;
+    }
+    sockFd_ = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    if (sockFd_ < 0) {
+        return false;
+    }
+    struct sockaddr_nl addr{};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = 1;
+    addr.nl_pid = 0;
+    if (bind(sockFd_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        return false;
+    }
+
+    using namespace std::placeholders;
+    return Reactor::GetInstance()->AddFd(sockFd_, EPOLLIN, std::bind(&UeventScreenStateProvider::SocketReadable_, this, _1));
+}
+
+const char* UeventScreenStateProvider::GetName() const
+{
+    return "uevent";
+}
+
+void UeventScreenStateProvider::SocketReadable_(uint32_t)
+{
+    bool changed = false;
+    for (;;) {
+        char buffer[4096] = { 0 };
+        ssize_t len = recv(sockFd_, buffer, sizeof(buffer) - 1, 0);
+        if (len <= 0) {
+            break;
+        }
+        // "<action>@<devpath>\0KEY=VALUE\0KEY=VALUE\0..."
+        for (ssize_t offset = 0; offset < len; offset += strlen(buffer + offset) + 1) {
+            const char* field = buffer + offset;
+            if (strcmp(field, "SUBSYSTEM=backlight") == 0 || strcmp(field, "SUBSYSTEM=leds") == 0 || 
+                strcmp(field, "SUBSYSTEM=drm") == 0) {
+                changed = true;
+                break;
+            }
+        }
+    }
+    if (changed) {
+        BrightnessChanged_();
+    }
+}
+
+HeuristicScreenStateProvider::HeuristicScreenStateProvider(const int &androidSDKVersion) : 
+    ScreenStateProvider(), 
+    androidSDKVersion_(androidSDKVersion), 
+    inotifyFd_(-1) { }
+
+HeuristicScreenStateProvider::~HeuristicScreenStateProvider()
+{
+    if (inotifyFd_ >= 0) {
+        Reactor::GetInstance()->RemoveFd(inotifyFd_);
+        close(inotifyFd_);
+    }
+}
+
+bool HeuristicScreenStateProvider::Init(const StateCallback &callback)
+{
+    SetCallback_(callback, Evaluate_());
+
+    std::string watchPath = "";
+    if (androidSDKVersion_ < 29) {
+        watchPath = "/sys/power/wake_lock";
+    } else if (androidSDKVersion_ < 33) {
+        watchPath = "/dev/cpuset/restricted/tasks";
+    } else {
+        watchPath = "/dev/cpuset/restricted/cgroup.procs";
+    }
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0) {
+        return false;
+    }
+    if (inotify_add_watch(inotifyFd_, watchPath.c_str(), IN_MODIFY) < 0) {
+        return false;
+    }
+
+    using namespace std::placeholders;
+    return Reactor::GetInstance()->AddFd(inotifyFd_, EPOLLIN, std::bind(&HeuristicScreenStateProvider::InotifyReadable_, this, _1));
+}
+
+const char* HeuristicScreenStateProvider::GetName() const
+{
+    return "heuristic";
+}
+
+void HeuristicScreenStateProvider::InotifyReadable_(uint32_t)
+{
+    DrainInotify_(inotifyFd_);
+    UpdateState_(Evaluate_());
+}
+
+int HeuristicScreenStateProvider::Evaluate_() const
+{
+    int state = SCREEN_ON;
+    if (androidSDKVersion_ < 29) {
+        state = GetScreenStateViaWakelock();
+    } else {
+        state = GetScreenStateViaCgroup();
+    }
+
+    return state;
+}
+
+std::unique_ptr<ScreenStateProvider> CreateScreenStateProvider(const int &androidSDKVersion, 
+    const ScreenStateProvider::StateCallback &callback)
+{
+    std::unique_ptr<ScreenStateProvider> provider(new UeventScreenStateProvider(androidSDKVersion));
+    if (!provider->Init(callback)) {
+        provider.reset(new BacklightScreenStateProvider(androidSDKVersion));
+        if (!provider->Init(callback)) {
+            provider.reset(new HeuristicScreenStateProvider(androidSDKVersion));
+            provider->Init(callback);
+        }
+    }
+
+    return provider;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <atomic>
+#include "platform/reactor.h"
+#include "utils/cu_misc.h"
+
+// Keeps the last known screen state and reports real transitions only.
+// Implementations register their notification fd with the Reactor and re-evaluate when it fires,
+// so readers never touch a file to learn the screen state.
+class ScreenStateProvider
+{
+    public:
+        using StateCallback = std::function<void(int)>;
+
+        ScreenStateProvider();
+        virtual ~ScreenStateProvider();
+        virtual bool Init(const StateCallback &callback) = 0;
+        virtual const char* GetName() const = 0;
+        int GetState() const;
+
+    protected:
+        void UpdateState_(const int &state);
+        void SetCallback_(const StateCallback &callback, const int &state);
+
+    private:
+        StateCallback callback_;
+        std::atomic<int> state_;
+};
+
+// The old heuristics (restricted cgroup size, display wakelock), re-evaluated only when their source file changes.
+class HeuristicScreenStateProvider : public ScreenStateProvider
+{
+    public:
+        HeuristicScreenStateProvider(const int &androidSDKVersion);
+        ~HeuristicScreenStateProvider();
+        bool Init(const StateCallback &callback) override;
+        const char* GetName() const override;
+
+    private:
+        int androidSDKVersion_;
+        int inotifyFd_;
+
+        void InotifyReadable_(uint32_t events);
+        int Evaluate_() const;
+};
+
+// Reads the panel brightness, and bl_power where the backlight class has it, 0 or a blanked panel means off.
+// Panels blanked through DRM may never write brightness 0, so the source is only trusted once it has reported
+// the screen off; until then the heuristic provider decides.
+class BrightnessScreenStateProvider : public ScreenStateProvider
+{
+    public:
+        BrightnessScreenStateProvider(const int &androidSDKVersion);
+        ~BrightnessScreenStateProvider();
+
+    protected:
+        std::string brightnessPath_;
+
+        bool InitBrightness_(const StateCallback &callback);
+        void BrightnessChanged_();
+
+    private:
+        int androidSDKVersion_;
+        int brightnessFd_;
+        int blPowerFd_;
+        bool verified_;
+        std::unique_ptr<HeuristicScreenStateProvider> heuristic_;
+
+        int ReadState_() const;
+        void HeuristicChanged_(const int &state);
+};
+
+// Watches the panel brightness file with inotify.
+class BacklightScreenStateProvider : public BrightnessScreenStateProvider
+{
+    public:
+        BacklightScreenStateProvider(const int &androidSDKVersion);
+        ~BacklightScreenStateProvider();
+        bool Init(const StateCallback &callback) override;
+        const char* GetName() const override;
+
+    private:
+        int inotifyFd_;
+
+        void InotifyReadable_(uint32_t events);
+};
+
+// Listens for kobject uevents of the backlight, leds and drm subsystems and re-reads the brightness,
+// which also catches bl_power changes made by the kernel that inotify never sees.
+class UeventScreenStateProvider : public BrightnessScreenStateProvider
+{
+    public:
+        UeventScreenStateProvider(const int &androidSDKVersion);
+        ~UeventScreenStateProvider();
+        bool Init(const StateCallback &callback) override;
+        const char* GetName() const override;
+
+    private:
+        int sockFd_;
+
+        void SocketReadable_(uint32_t events);
+};
+
+// Returns the first provider that works on this device: uevent, then backlight, the heuristic one as the last resort.
+std::unique_ptr<ScreenStateProvider> CreateScreenStateProvider(const int &androidSDKVersion, 
+    const ScreenStateProvider::StateCallback &callback);
@@ -0,0 +1,158 @@
+#include "task_watcher.h"
+
+#ifndef __NR_pidfd_send_signal
+#define __NR_pidfd_send_signal 424
+#endif
+#ifndef __NR_pidfd_open
+#define __NR_pidfd_open 434
+#endif
+
+TaskWatcher::TaskWatcher() : 
+    supported_(false), 
+    callback_(), 
+    procReader_(), 
+    pidfdMap_(), 
+    mtx_() { }
+
+TaskWatcher::~TaskWatcher() { }
+
+bool TaskWatcher::Init(const ExitCallback &callback)
+{
+    // pidfd_open() is available since Linux 5.3.
+    int pidfd = PidfdOpen_(getpid());
+    if (pidfd < 0) {
+        return false;
+    }
+    close(pidfd);
+
+    callback_ = callback;
+    supported_ = true;
+
+    return true;
+}
+
+bool TaskWatcher::IsSupported() const
+{
+    return supported_;
+}
+
+bool TaskWatcher::WatchTask(const int &pid, const uint64_t &startTime)
+{
+    if (!supported_) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lck(mtx_);
+    if (pidfdMap_.count(pid) == 1) {
+        return true;
+    }
+    int pidfd = PidfdOpen_(pid);
+    if (pidfd < 0) {
+        return false;
+    }
+    // The pidfd pins the process; if its starttime still matches, it is the task we classified.
+    if (!IsSameTask_(pid, startTime)) {
+        close(pidfd);
+        return false;
+    }
+    if (!Reactor::GetInstance()->AddFd(pidfd, EPOLLIN, std::bind(&TaskWatcher::TaskExited_, this, pid, pidfd))) {
+        close(pidfd);
+        return false;
+    }
+    pidfdMap_[pid] = pidfd;
+
+    return true;
+}
+
+void TaskWatcher::UnwatchTask(const int &pid)
+{
+    std::unique_lock<std::mutex> lck(mtx_);
+    const auto &iter = pidfdMap_.find(pid);
+    if (iter != pidfdMap_.end()) {
+        Reactor::GetInstance()->RemoveFd(iter->second);
+        close(iter->second);
+        pidfdMap_.erase(iter);
+    }
+}
+
+int TaskWatcher::SendSignal(const int &pid, const uint64_t &startTime, const int &sig)
+{
+    {
+        std::unique_lock<std::mutex> lck(mtx_);
+        const auto &iter = pidfdMap_.find(pid);
+        if (iter != pidfdMap_.end()) {
+            return PidfdSendSignal_(iter->second, sig);
+        }
+    }
+    if (!supported_) {
+        // Before Linux 5.3 there is no pidfd, checking starttime right before kill() is the closest there is.
+        if (!IsSameTask_(pid, startTime)) {
+            errno = ESRCH;
+            return -1;
+        }
+        return kill(pid, sig);
+    }
+
+    int pidfd = PidfdOpen_(pid);
+    if (pidfd < 0) {
+        return -1;
+    }
+    int ret = -1;
+    if (IsSameTask_(pid, startTime)) {
+        ret = PidfdSendSignal_(pidfd, sig);
+    } else {
+        errno = ESRCH;
+    }
+    close(pidfd);
+
+    return ret;
+}
+
+int TaskWatcher::SendSignal(const int &pid, const int &sig)
+{
+    {
+        std::unique_lock<std::mutex> lck(mtx_);
+        const auto &iter = pidfdMap_.find(pid);
+        if (iter != pidfdMap_.end()) {
+            return PidfdSendSignal_(iter->second, sig);
+        }
+    }
+    if (!supported_) {
+        // Without pidfd support nothing is watched, the SIGSTOP freezer backend still needs its signals.
+        return kill(pid, sig);
+    }
+    errno = ESRCH;
+
+    return -1;
+}
+
+void TaskWatcher::TaskExited_(const int &pid, const int &pidfd)
+{
+    {
+        std::unique_lock<std::mutex> lck(mtx_);
+        const auto &iter = pidfdMap_.find(pid);
+        if (iter == pidfdMap_.end() || iter->second != pidfd) {
+            return;
+        }
+        Reactor::GetInstance()->RemoveFd(pidfd);
+        close(pidfd);
+        pidfdMap_.erase(iter);
+    }
+    callback_(pid);
+}
+
+bool TaskWatcher::IsSameTask_(const int &pid, const uint64_t &startTime) const
+{
+    ProcTaskInfo info{};
+    return procReader_.ReadTask(pid, PROC_READ_STAT, &info) && info.startTime == startTime;
+}
+
+int TaskWatcher::PidfdOpen_(const int &pid)
+{
+    return (int)syscall(__NR_pidfd_open, pid, 0);
+}
+
+int TaskWatcher::PidfdSendSignal_(const int &pidfd, const int &sig)
+{
+    return (int)syscall(__NR_pidfd_send_signal, pidfd, sig, nullptr, 0);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <csignal>
+#include <sys/syscall.h>
+#include "platform/reactor.h"
+#include "utils/cu_misc.h"
+#include "utils/proc_reader.h"
+
+// Holds a pidfd for every watched task, so signals can never reach a process that reused its pid,
+// and reports task exits as soon as the kernel marks the pidfd readable (polled by the Reactor).
+class TaskWatcher
+{
+    public:
+        using ExitCallback = std::function<void(int)>;
+
+        TaskWatcher();
+        ~TaskWatcher();
+        bool Init(const ExitCallback &callback);
+        bool IsSupported() const;
+        bool WatchTask(const int &pid, const uint64_t &startTime);
+        void UnwatchTask(const int &pid);
+        // Signals the task only while it is still the process started at startTime, through a pidfd.
+        int SendSignal(const int &pid, const uint64_t &startTime, const int &sig);
+        // Signals a watched task, unwatched pids are refused (ESRCH) since their identity can't be checked.
+        int SendSignal(const int &pid, const int &sig);
+
+    private:
+        bool supported_;
+        ExitCallback callback_;
+        ProcReader procReader_;
+        std::unordered_map<int, int> pidfdMap_;
+        std::mutex mtx_;
+
+        void TaskExited_(const int &pid, const int &pidfd);
+        bool IsSameTask_(const int &pid, const uint64_t &startTime) const;
+        static int PidfdOpen_(const int &pid);
+        static int PidfdSendSignal_(const int &pidfd, const int &sig);
+};
@@ -0,0 +1,145 @@
+#include "timer_wheel.h"
+
+TimerWheel::TimerWheel(const uint64_t &tickMs, const size_t &slotNum) : 
+    tickMs_(tickMs), 
+    slots_(slotNum, -1), 
+    nodes_(), 
+    freeNodes_(), 
+    currentTick_(GetTimeStampMs() / tickMs), 
+    size_(0) { }
+
+TimerWheel::~TimerWheel() { }
+
+TimerWheel::TimerId TimerWheel::Schedule(const uint64_t &deadlineMs, const std::string &key, const int &tag)
+{
+    int32_t idx = -1;
+    if (freeNodes_.empty()) {
+        idx = (int32_t)nodes_.size();
+        nodes_.emplace_back(Node{0, "", 0, 0, -1, -1, -1});
+    } else {
+        idx = freeNodes_.back();
+        freeNodes_.pop_back();
+    }
+    auto &node = nodes_[idx];
+    node.deadlineMs = deadlineMs;
+    node.key = key;
+    node.tag = tag;
+    node.generation++;
+
+    // A slot is visited once its tick has fully started, so deadlines are rounded up to a tick.
+    // Deadlines that are already due land in the next slot to be visited.
+    uint64_t tick = std::max((deadlineMs + tickMs_ - 1) / tickMs_, currentTick_ + 1);
+    Link_(idx, (int32_t)(tick % slots_.size()));
+    size_++;
+
+    return ((TimerId)node.generation << 32) | (TimerId)(idx + 1);
+}
+
+void TimerWheel::Cancel(const TimerId &timerId)
+{
+    int32_t idx = (int32_t)(timerId & 0xFFFFFFFF) - 1;
+    uint32_t generation = (uint32_t)(timerId >> 32);
+    if (idx >= 0 && idx < (int32_t)nodes_.size() && nodes_[idx].generation == generation && nodes_[idx].slot >= 0) {
+        Unlink_(idx);
+        freeNodes_.emplace_back(idx);
+        size_--;
+    }
+}
+
+void TimerWheel::Advance(const uint64_t &nowMs, const ExpireCallback &callback)
+{
+    uint64_t targetTick = nowMs / tickMs_;
+    if (targetTick <= currentTick_) {
+        return;
+    }
+    if (size_ == 0) {
+        currentTick_ = targetTick;
+        return;
+    }
+
+    std::vector<int32_t> expiredNodes{};
+    // Visiting more than one revolution would only revisit the same slots.
+    uint64_t tickNum = std::min(targetTick - currentTick_, (uint64_t)slots_.size());
+    for (uint64_t i = 1; i <= tickNum; i++) {
+        int32_t idx = slots_[(currentTick_ + i) % slots_.size()];
+        while (idx >= 0) {
+            int32_t next = nodes_[idx].next;
+            if (nodes_[idx].deadlineMs <= nowMs) {
+                Unlink_(idx);
+                expiredNodes.emplace_back(idx);
+            }
+            idx = next;
+        }
+    }
+    currentTick_ = targetTick;
+
+    // Callbacks may schedule new timers, so expired nodes are released before any of them runs.
+    std::vector<std::pair<std::string, int>> expiredTimers{};
+    for (const int32_t &idx : expiredNodes) {
+        expiredTimers.emplace_back(std::move(nodes_[idx].key), nodes_[idx].tag);
+        freeNodes_.emplace_back(idx);
+        size_--;
+    }
+    for (const auto &[key, tag] : expiredTimers) {
+        callback(key, tag);
+    }
+}
+
+uint64_t TimerWheel::GetNextDeadlineMs() const
+{
+    if (size_ == 0) {
+        return UINT64_MAX;
+    }
+
+    // The first slot holding a deadline of the current revolution has the earliest one;
+    // if there is none, every timer is at least one revolution away.
+    uint64_t laterTick = UINT64_MAX;
+    for (size_t i = 1; i <= slots_.size(); i++) {
+        uint64_t slotTick = currentTick_ + i;
+        int32_t idx = slots_[slotTick % slots_.size()];
+        while (idx >= 0) {
+            const auto &node = nodes_[idx];
+            uint64_t tick = std::max((node.deadlineMs + tickMs_ - 1) / tickMs_, slotTick);
+            if (tick == slotTick) {
+                return slotTick * tickMs_;
+            }
+            laterTick = std::min(laterTick, tick);
+            idx = node.next;
+        }
+    }
+
+    return laterTick * tickMs_;
+}
+
+size_t TimerWheel::GetSize() const
+{
+    return size_;
+}
+
+void TimerWheel::Link_(const int32_t &idx, const int32_t &slot)
+{
+    auto &node = nodes_[idx];
+    node.slot = slot;
+    node.prev = -1;
+    node.next = slots_[slot];
+    if (node.next >= 0) {
+        nodes_[node.next].prev = idx;
+    }
+    slots_[slot] = idx;
+}
+
+void TimerWheel::Unlink_(const int32_t &idx)
+{
+    auto &node = nodes_[idx];
+    if (node.prev >= 0) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        slots_[node.slot] = node.next;
+    }
+    if (node.next >= 0) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.slot = -1;
+    node.prev = -1;
+    node.next = -1;
+}
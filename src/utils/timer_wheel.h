@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <climits>
+#include <utility>
+#include <algorithm>
+#include "utils/cu_misc.h"
+
+// Hashed timer wheel for per-app deadlines, driven by the thread that owns it.
+// Schedule and Cancel are O(1); Advance only visits the slots of elapsed ticks.
+// Deadlines further away than one wheel revolution stay in their slot until their round comes.
+class TimerWheel
+{
+    public:
+        using TimerId = uint64_t;
+        using ExpireCallback = std::function<void(const std::string &, const int &)>;
+
+        static constexpr TimerId INVALID_TIMER = 0;
+
+        TimerWheel(const uint64_t &tickMs, const size_t &slotNum);
+        ~TimerWheel();
+        TimerId Schedule(const uint64_t &deadlineMs, const std::string &key, const int &tag);
+        void Cancel(const TimerId &timerId);
+        void Advance(const uint64_t &nowMs, const ExpireCallback &callback);
+        uint64_t GetNextDeadlineMs() const;
+        size_t GetSize() const;
+
+    private:
+        typedef struct {
+            uint64_t deadlineMs;
+            std::string key;
+            int tag;
+            uint32_t generation;
+            int32_t slot;
+            int32_t prev;
+            int32_t next;
+        } Node;
+
+        uint64_t tickMs_;
+        std::vector<int32_t> slots_;
+        std::vector<Node> nodes_;
+        std::vector<int32_t> freeNodes_;
+        uint64_t currentTick_;
+        size_t size_;
+
+        void Link_(const int32_t &idx, const int32_t &slot);
+        void Unlink_(const int32_t &idx);
+};